@@ -1,38 +1,30 @@
 /*
- * Compiladores - etapa6 - asm.cpp - semestre 2025/2
+ * Compiladores - etapa7 - asm.cpp - semestre 2025/2
  * Autor: Santiago Gonzaga
  *
  * Implementação da geração de código assembly ARM64 para macOS (Apple Silicon)
+ * e x86-64 para Linux (System V AMD64 ABI, sintaxe AT&T, ELF)
  */
 
 #include "asm.hpp"
+#include "emitter.hpp"
 #include "ast.hpp"
+#include "regalloc.hpp"
+#include "threadpool.hpp"
+#include "timing.hpp"
+#include <algorithm>
 #include <vector>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 // Declaração externa da tabela de símbolos
 extern SymbolTable* symbolTable;
 
-// Função auxiliar para verificar se um símbolo é um literal inteiro
-static bool isIntLiteral(SymbolNode* sym) {
-    if (!sym) return false;
-    return sym->type == SYMBOL_LIT_INT;
-}
-
-// Função auxiliar para verificar se um símbolo é um literal char
-static bool isCharLiteral(SymbolNode* sym) {
-    if (!sym) return false;
-    return sym->type == SYMBOL_LIT_CHAR;
-}
-
-// Função auxiliar para verificar se um símbolo é um literal booleano
-static bool isBoolLiteral(SymbolNode* sym) {
-    if (!sym) return false;
-    return sym->type == SYMBOL_LIT_BOOL;
-}
-
 // Função auxiliar para verificar se um símbolo é um literal string
 static bool isStringLiteral(SymbolNode* sym) {
     if (!sym) return false;
@@ -45,6 +37,12 @@ static bool isFunction(SymbolNode* sym) {
     return sym->nature == NATURE_FUNCTION;
 }
 
+// Número de elementos de um vetor (ao menos 1, para nunca reservar 0 bytes)
+static int vectorLength(SymbolNode* sym) {
+    if (!sym || sym->vectorSize < 1) return 1;
+    return sym->vectorSize;
+}
+
 // Contador global para strings
 static int stringCounter = 0;
 static std::map<std::string, std::string> stringNames;
@@ -85,6 +83,18 @@ static std::string makeAsmName(const std::string& name) {
     return result;
 }
 
+// Nomes assembly já calculados na função sendo gerada (um cache por
+// thread, esvaziado a cada função: na compilação em fluxo os temporários e
+// labels são liberados após cada função e seus endereços, reaproveitados)
+static thread_local std::unordered_map<SymbolNode*, std::string> asmNames;
+
+// Nome assembly de um símbolo, calculado uma vez por função
+static const char* asmName(SymbolNode* sym) {
+    std::string& name = asmNames[sym];
+    if (name.empty()) name = makeAsmName(symbolName(sym));
+    return name.c_str();
+}
+
 // Nome para função - macOS requer prefixo _ em todas as funções
 static std::string makeFunctionName(const std::string& name) {
     return "_" + name;
@@ -93,117 +103,174 @@ static std::string makeFunctionName(const std::string& name) {
 // Função auxiliar para verificar se é um label
 static bool isLabel(SymbolNode* sym) {
     if (!sym) return false;
-    return sym->text.find("__label") == 0;
+    return sym->type == SYMBOL_LABEL;
 }
 
 // Função para gerar seção .data com variáveis e constantes
-static void generateDataSection(FILE* output) {
-    fprintf(output, "// Seção de dados\n");
-    fprintf(output, ".data\n\n");
+static void generateDataSection(AsmEmitter& output) {
+    output.format("// Seção de dados\n");
+    output.format(".data\n\n");
 
     // Formato para print de inteiros
-    fprintf(output, "_printint:\n");
-    fprintf(output, "\t.asciz \"%%d\"\n\n");
+    output.format("_printint:\n");
+    output.format("\t.asciz \"%%d\"\n\n");
 
     // Formato para print de inteiros com newline
-    fprintf(output, "_printintln:\n");
-    fprintf(output, "\t.asciz \"%%d\\n\"\n\n");
+    output.format("_printintln:\n");
+    output.format("\t.asciz \"%%d\\n\"\n\n");
 
     // Formato para read de inteiros
-    fprintf(output, "_readint:\n");
-    fprintf(output, "\t.asciz \"%%d\"\n\n");
+    output.format("_readint:\n");
+    output.format("\t.asciz \"%%d\"\n\n");
+}
+
+// Registradores preservados entre chamadas (AAPCS64) usados pelo alocador
+static const int ARM_CALLEE_SAVED = 10;      // x19..x28
+static const RegisterSet armRegisters = {ARM_CALLEE_SAVED, 0};
+
+// Alocação de registradores da função sendo gerada (uma por thread, pois
+// as funções são geradas em paralelo)
+static thread_local const RegAllocation* armAlloc = nullptr;
+
+// Número do registrador ARM64 (19..28) do símbolo, ou -1 se está em memória
+static int armRegisterOf(SymbolNode* sym) {
+    int reg = armAlloc ? armAlloc->location(sym) : -1;
+    return reg >= 0 ? 19 + reg : -1;
+}
+
+// Tamanho do frame abaixo de x29: registradores preservados salvos e slots
+// dos locais que ficaram em memória (múltiplo de 16)
+static int armFrameSize() {
+    if (!armAlloc) return 0;
+    int bytes = 8 * (int)armAlloc->calleeSavedUsed.size() + armAlloc->frameBytes;
+    return (bytes + 15) / 16 * 16;
+}
+
+// Distância abaixo de x29 do slot do símbolo no frame, ou 0 se não tem slot
+static int armFrameOffset(SymbolNode* sym) {
+    int slot = armAlloc ? armAlloc->frameSlot(sym) : 0;
+    if (slot == 0) return 0;
+    return 8 * (int)armAlloc->calleeSavedUsed.size() + slot;
+}
+
+// Leitura/escrita de wN em um slot do frame (ldur/stur alcançam 256 bytes;
+// slots mais distantes têm o endereço calculado em xScratch)
+static void armFrameAccess(bool store, int reg, int offset, int scratch, AsmEmitter& output) {
+    if (offset <= 256) {
+        output.format("\t%s w%d, [x29, #-%d]\n", store ? "stur" : "ldur", reg, offset);
+    } else {
+        output.format("\tmov x%d, #%d\n", scratch, offset);
+        output.format("\tsub x%d, x29, x%d\n", scratch, scratch);
+        output.format("\t%s w%d, [x%d]\n", store ? "str" : "ldr", reg, scratch);
+    }
+}
+
+// Epílogo: restaura registradores preservados, frame pointer e retorna
+static void armEpilogue(AsmEmitter& output) {
+    if (armAlloc) {
+        for (size_t i = 0; i < armAlloc->calleeSavedUsed.size(); i++) {
+            output.format("\tldur x%d, [x29, #-%d]\n",
+                    19 + armAlloc->calleeSavedUsed[i], (int)(8 * (i + 1)));
+        }
+    }
+    if (armFrameSize() > 0) {
+        output.format("\tmov sp, x29\n");
+    }
+    output.format("\tldp x29, x30, [sp], #16\n");
+    output.format("\tret\n");
+}
+
+// Carrega uma constante de 32 bits em wN (mov + movk quando não cabe em 16 bits)
+static void armLoadImmediate(int reg, int value, AsmEmitter& output) {
+    if (value >= 0 && value < 65536) {
+        output.format("\tmov w%d, #%d\n", reg, value);
+    } else {
+        output.format("\tmov w%d, #%d\n", reg, value & 0xFFFF);
+        output.format("\tmovk w%d, #%d, lsl #16\n", reg, (value >> 16) & 0xFFFF);
+    }
 }
 
 // Função auxiliar para carregar valor em registrador w0
 // Retorna true se o valor já está em w0
-static void loadToW0(SymbolNode* sym, FILE* output) {
+static void loadToW0(SymbolNode* sym, AsmEmitter& output) {
     if (!sym) {
-        fprintf(output, "\tmov w0, #0\n");
+        output.format("\tmov w0, #0\n");
         return;
     }
 
-    if (isIntLiteral(sym)) {
-        int val = atoi(sym->text.c_str());
-        if (val >= 0 && val < 65536) {
-            fprintf(output, "\tmov w0, #%d\n", val);
-        } else {
-            fprintf(output, "\tmov w0, #%d\n", val & 0xFFFF);
-            if (val > 65535 || val < 0) {
-                fprintf(output, "\tmovk w0, #%d, lsl #16\n", (val >> 16) & 0xFFFF);
-            }
-        }
-    } else if (isCharLiteral(sym)) {
-        if (sym->text.length() >= 3) {
-            char c = sym->text[1];
-            fprintf(output, "\tmov w0, #%d\n", (int)c);
-        } else {
-            fprintf(output, "\tmov w0, #0\n");
-        }
-    } else if (isBoolLiteral(sym)) {
-        if (sym->text == "true") {
-            fprintf(output, "\tmov w0, #1\n");
-        } else {
-            fprintf(output, "\tmov w0, #0\n");
-        }
+    if (armRegisterOf(sym) >= 0) {
+        output.format("\tmov w0, w%d\n", armRegisterOf(sym));
+        return;
+    }
+
+    if (armFrameOffset(sym) > 0) {
+        armFrameAccess(false, 0, armFrameOffset(sym), 1, output);
+        return;
+    }
+
+    if (isConstant(sym)) {
+        armLoadImmediate(0, constantValue(sym), output);
     } else {
         // Variável - carregar do endereço
-        std::string name = makeAsmName(sym->text);
-        fprintf(output, "\tadrp x1, %s@PAGE\n", name.c_str());
-        fprintf(output, "\tadd x1, x1, %s@PAGEOFF\n", name.c_str());
-        fprintf(output, "\tldr w0, [x1]\n");
+        const char* name = asmName(sym);
+        output.format("\tadrp x1, %s@PAGE\n", name);
+        output.format("\tadd x1, x1, %s@PAGEOFF\n", name);
+        output.format("\tldr w0, [x1]\n");
     }
 }
 
 // Função auxiliar para carregar valor em registrador w1
-static void loadToW1(SymbolNode* sym, FILE* output) {
+static void loadToW1(SymbolNode* sym, AsmEmitter& output) {
     if (!sym) {
-        fprintf(output, "\tmov w1, #0\n");
+        output.format("\tmov w1, #0\n");
         return;
     }
 
-    if (isIntLiteral(sym)) {
-        int val = atoi(sym->text.c_str());
-        if (val >= 0 && val < 65536) {
-            fprintf(output, "\tmov w1, #%d\n", val);
-        } else {
-            fprintf(output, "\tmov w1, #%d\n", val & 0xFFFF);
-            if (val > 65535 || val < 0) {
-                fprintf(output, "\tmovk w1, #%d, lsl #16\n", (val >> 16) & 0xFFFF);
-            }
-        }
-    } else if (isCharLiteral(sym)) {
-        if (sym->text.length() >= 3) {
-            char c = sym->text[1];
-            fprintf(output, "\tmov w1, #%d\n", (int)c);
-        } else {
-            fprintf(output, "\tmov w1, #0\n");
-        }
-    } else if (isBoolLiteral(sym)) {
-        if (sym->text == "true") {
-            fprintf(output, "\tmov w1, #1\n");
-        } else {
-            fprintf(output, "\tmov w1, #0\n");
-        }
+    if (armRegisterOf(sym) >= 0) {
+        output.format("\tmov w1, w%d\n", armRegisterOf(sym));
+        return;
+    }
+
+    if (armFrameOffset(sym) > 0) {
+        armFrameAccess(false, 1, armFrameOffset(sym), 2, output);
+        return;
+    }
+
+    if (isConstant(sym)) {
+        armLoadImmediate(1, constantValue(sym), output);
     } else {
         // Variável - carregar do endereço
-        std::string name = makeAsmName(sym->text);
-        fprintf(output, "\tadrp x2, %s@PAGE\n", name.c_str());
-        fprintf(output, "\tadd x2, x2, %s@PAGEOFF\n", name.c_str());
-        fprintf(output, "\tldr w1, [x2]\n");
+        const char* name = asmName(sym);
+        output.format("\tadrp x2, %s@PAGE\n", name);
+        output.format("\tadd x2, x2, %s@PAGEOFF\n", name);
+        output.format("\tldr w1, [x2]\n");
     }
 }
 
-// Função auxiliar para armazenar w0 em variável
-static void storeW0To(SymbolNode* sym, FILE* output) {
+// Função auxiliar para armazenar wN em variável, usando xScratch para o endereço
+static void storeRegTo(SymbolNode* sym, int reg, int scratch, AsmEmitter& output) {
     if (!sym) return;
-    std::string name = makeAsmName(sym->text);
-    fprintf(output, "\tadrp x1, %s@PAGE\n", name.c_str());
-    fprintf(output, "\tadd x1, x1, %s@PAGEOFF\n", name.c_str());
-    fprintf(output, "\tstr w0, [x1]\n");
+    if (armRegisterOf(sym) >= 0) {
+        output.format("\tmov w%d, w%d\n", armRegisterOf(sym), reg);
+        return;
+    }
+    if (armFrameOffset(sym) > 0) {
+        armFrameAccess(true, reg, armFrameOffset(sym), scratch, output);
+        return;
+    }
+    const char* name = asmName(sym);
+    output.format("\tadrp x%d, %s@PAGE\n", scratch, name);
+    output.format("\tadd x%d, x%d, %s@PAGEOFF\n", scratch, scratch, name);
+    output.format("\tstr w%d, [x%d]\n", reg, scratch);
+}
+
+// Função auxiliar para armazenar w0 em variável
+static void storeW0To(SymbolNode* sym, AsmEmitter& output) {
+    storeRegTo(sym, 0, 1, output);
 }
 
 // Função para gerar uma instrução TAC em assembly ARM64
-static void generateTacAsm(TAC* tac, FILE* output) {
+static void generateTacAsm(TAC* tac, AsmEmitter& output) {
     if (!tac) return;
 
     switch(tac->type) {
@@ -214,7 +281,8 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_MOVE:
             // res = op1
             if (tac->res && tac->op1) {
-                fprintf(output, "\t// MOVE %s = %s\n", tac->res->text.c_str(), tac->op1->text.c_str());
+                if (!output.lean())
+                    output.note("\t// MOVE %s = %s\n", symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
                 loadToW0(tac->op1, output);
                 storeW0To(tac->res, output);
             }
@@ -223,11 +291,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_ADD:
             // res = op1 + op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// ADD %s = %s + %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// ADD %s = %s + %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tadd w0, w0, w1\n");
+                output.format("\tadd w0, w0, w1\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -235,11 +304,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_SUB:
             // res = op1 - op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// SUB %s = %s - %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// SUB %s = %s - %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tsub w0, w0, w1\n");
+                output.format("\tsub w0, w0, w1\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -247,11 +317,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_MUL:
             // res = op1 * op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// MUL %s = %s * %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// MUL %s = %s * %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tmul w0, w0, w1\n");
+                output.format("\tmul w0, w0, w1\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -259,11 +330,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_DIV:
             // res = op1 / op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// DIV %s = %s / %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// DIV %s = %s / %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tsdiv w0, w0, w1\n");
+                output.format("\tsdiv w0, w0, w1\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -271,12 +343,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_MOD:
             // res = op1 % op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// MOD %s = %s %% %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// MOD %s = %s %% %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tsdiv w2, w0, w1\n");
-                fprintf(output, "\tmsub w0, w2, w1, w0\n");  // w0 = w0 - w2*w1
+                output.format("\tsdiv w2, w0, w1\n");
+                output.format("\tmsub w0, w2, w1, w0\n");  // w0 = w0 - w2*w1
                 storeW0To(tac->res, output);
             }
             break;
@@ -284,12 +357,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_LT:
             // res = op1 < op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// LT %s = %s < %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// LT %s = %s < %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tcmp w0, w1\n");
-                fprintf(output, "\tcset w0, lt\n");
+                output.format("\tcmp w0, w1\n");
+                output.format("\tcset w0, lt\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -297,12 +371,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_GT:
             // res = op1 > op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// GT %s = %s > %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// GT %s = %s > %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tcmp w0, w1\n");
-                fprintf(output, "\tcset w0, gt\n");
+                output.format("\tcmp w0, w1\n");
+                output.format("\tcset w0, gt\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -310,12 +385,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_LE:
             // res = op1 <= op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// LE %s = %s <= %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// LE %s = %s <= %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tcmp w0, w1\n");
-                fprintf(output, "\tcset w0, le\n");
+                output.format("\tcmp w0, w1\n");
+                output.format("\tcset w0, le\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -323,12 +399,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_GE:
             // res = op1 >= op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// GE %s = %s >= %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// GE %s = %s >= %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tcmp w0, w1\n");
-                fprintf(output, "\tcset w0, ge\n");
+                output.format("\tcmp w0, w1\n");
+                output.format("\tcset w0, ge\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -336,12 +413,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_EQ:
             // res = op1 == op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// EQ %s = %s == %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// EQ %s = %s == %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tcmp w0, w1\n");
-                fprintf(output, "\tcset w0, eq\n");
+                output.format("\tcmp w0, w1\n");
+                output.format("\tcset w0, eq\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -349,12 +427,13 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_DIF:
             // res = op1 != op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// DIF %s = %s != %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// DIF %s = %s != %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tcmp w0, w1\n");
-                fprintf(output, "\tcset w0, ne\n");
+                output.format("\tcmp w0, w1\n");
+                output.format("\tcset w0, ne\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -362,11 +441,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_AND:
             // res = op1 && op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// AND %s = %s & %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// AND %s = %s & %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\tand w0, w0, w1\n");
+                output.format("\tand w0, w0, w1\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -374,11 +454,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_OR:
             // res = op1 || op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// OR %s = %s | %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// OR %s = %s | %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
                 loadToW0(tac->op1, output);
                 loadToW1(tac->op2, output);
-                fprintf(output, "\torr w0, w0, w1\n");
+                output.format("\torr w0, w0, w1\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -386,11 +467,12 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_NOT:
             // res = !op1
             if (tac->res && tac->op1) {
-                fprintf(output, "\t// NOT %s = ~%s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str());
+                if (!output.lean())
+                    output.note("\t// NOT %s = ~%s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
                 loadToW0(tac->op1, output);
-                fprintf(output, "\tcmp w0, #0\n");
-                fprintf(output, "\tcset w0, eq\n");
+                output.format("\tcmp w0, #0\n");
+                output.format("\tcset w0, eq\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -398,10 +480,11 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_NEG:
             // res = -op1
             if (tac->res && tac->op1) {
-                fprintf(output, "\t// NEG %s = -%s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str());
+                if (!output.lean())
+                    output.note("\t// NEG %s = -%s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
                 loadToW0(tac->op1, output);
-                fprintf(output, "\tneg w0, w0\n");
+                output.format("\tneg w0, w0\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -409,37 +492,45 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_LABEL:
             // Label para desvios
             if (tac->res) {
-                fprintf(output, "%s:\n", makeAsmName(tac->res->text).c_str());
+                output.format("%s:\n", asmName(tac->res));
             }
             break;
 
         case TAC_BEGINFUN:
             // Início de função
             if (tac->res) {
-                std::string funcName = makeFunctionName(tac->res->text);
-                fprintf(output, "\n// Função %s\n", tac->res->text.c_str());
-                fprintf(output, ".globl %s\n", funcName.c_str());
-                fprintf(output, ".p2align 2\n");
-                fprintf(output, "%s:\n", funcName.c_str());
+                std::string funcName = makeFunctionName(symbolName(tac->res));
+                if (!output.lean())
+                    output.note("\n// Função %s\n", symbolName(tac->res).c_str());
+                output.format(".globl %s\n", funcName.c_str());
+                output.format(".p2align 2\n");
+                output.format("%s:\n", funcName.c_str());
                 // Prólogo da função - salvar frame pointer e link register
-                fprintf(output, "\tstp x29, x30, [sp, #-16]!\n");
-                fprintf(output, "\tmov x29, sp\n");
-
-                // Se a função tiver parâmetros, salvá-los
-                if (tac->res->parameterList) {
-                    ASTNode* paramList = tac->res->parameterList;
-                    if (paramList && paramList->type == AST_PARAMETER_LIST) {
-                        ASTNode* firstParam = paramList->child[0];
-                        if (firstParam && firstParam->type == AST_PARAMETER) {
-                            ASTNode* paramId = firstParam->child[1];
-                            if (paramId && paramId->symbol) {
-                                fprintf(output, "\t// Salvando parâmetro %s\n", paramId->symbol->text.c_str());
-                                std::string name = makeAsmName(paramId->symbol->text);
-                                fprintf(output, "\tadrp x1, %s@PAGE\n", name.c_str());
-                                fprintf(output, "\tadd x1, x1, %s@PAGEOFF\n", name.c_str());
-                                fprintf(output, "\tstr w0, [x1]\n");
-                            }
-                        }
+                output.format("\tstp x29, x30, [sp, #-16]!\n");
+                output.format("\tmov x29, sp\n");
+
+                // Reservar o frame e salvar os registradores preservados usados
+                if (armFrameSize() > 0) {
+                    output.format("\tsub sp, sp, #%d\n", armFrameSize());
+                    for (size_t i = 0; i < armAlloc->calleeSavedUsed.size(); i++) {
+                        output.format("\tstur x%d, [x29, #-%d]\n",
+                                19 + armAlloc->calleeSavedUsed[i], (int)(8 * (i + 1)));
+                    }
+                }
+
+                // Salvar parâmetros: os 8 primeiros chegam em w0..w7, os demais
+                // ficam na pilha do chamador, 16 bytes cada, o último no topo
+                std::vector<SymbolNode*> params;
+                collectParameters(tac->res->parameterList, params);
+                int paramCount = (int)params.size();
+                for (int i = 0; i < paramCount; i++) {
+                    if (!output.lean())
+                        output.note("\t// Salvando parâmetro %s\n", params[i]->text.c_str());
+                    if (i < 8) {
+                        storeRegTo(params[i], i, 9, output);
+                    } else {
+                        output.format("\tldr w9, [x29, #%d]\n", 16 + 16 * (paramCount - 1 - i));
+                        storeRegTo(params[i], 9, 10, output);
                     }
                 }
             }
@@ -448,108 +539,175 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_ENDFUN:
             // Fim de função
             if (tac->res) {
-                fprintf(output, "\t// Fim da função %s\n", tac->res->text.c_str());
-                fprintf(output, "\tmov w0, #0\n");
-                fprintf(output, "\tldp x29, x30, [sp], #16\n");
-                fprintf(output, "\tret\n");
+                if (!output.lean())
+                    output.note("\t// Fim da função %s\n", symbolName(tac->res).c_str());
+                output.format("\tmov w0, #0\n");
+                armEpilogue(output);
             }
             break;
 
         case TAC_IFZ:
             // if op1 == 0 goto res
             if (tac->res && tac->op1) {
-                fprintf(output, "\t// IFZ: if %s == 0 goto %s\n",
-                        tac->op1->text.c_str(), tac->res->text.c_str());
+                if (!output.lean())
+                    output.note("\t// IFZ: if %s == 0 goto %s\n",
+                            symbolName(tac->op1).c_str(), symbolName(tac->res).c_str());
+                loadToW0(tac->op1, output);
+                output.format("\tcbz w0, %s\n", asmName(tac->res));
+            }
+            break;
+
+        case TAC_IFNZ:
+            // if op1 != 0 goto res
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t// IFNZ: if %s != 0 goto %s\n",
+                            symbolName(tac->op1).c_str(), symbolName(tac->res).c_str());
                 loadToW0(tac->op1, output);
-                fprintf(output, "\tcbz w0, %s\n", makeAsmName(tac->res->text).c_str());
+                output.format("\tcbnz w0, %s\n", asmName(tac->res));
+            }
+            break;
+
+        case TAC_JLT:
+        case TAC_JGT:
+        case TAC_JLE:
+        case TAC_JGE:
+        case TAC_JEQ:
+        case TAC_JNE:
+            // if op1 <cond> op2 goto res - uma comparação e um desvio
+            if (tac->res && tac->op1 && tac->op2) {
+                const char* cond = "eq";
+                const char* symbol = "==";
+                switch (tac->type) {
+                    case TAC_JLT: cond = "lt"; symbol = "<"; break;
+                    case TAC_JGT: cond = "gt"; symbol = ">"; break;
+                    case TAC_JLE: cond = "le"; symbol = "<="; break;
+                    case TAC_JGE: cond = "ge"; symbol = ">="; break;
+                    case TAC_JEQ: cond = "eq"; symbol = "=="; break;
+                    case TAC_JNE: cond = "ne"; symbol = "!="; break;
+                }
+                if (!output.lean())
+                    output.note("\t// %s: if %s %s %s goto %s\n", tacTypeName(tac->type) + 4,
+                            symbolName(tac->op1).c_str(), symbol, symbolName(tac->op2).c_str(), symbolName(tac->res).c_str());
+                // Operandos em registradores alocados são comparados diretamente
+                int left = armRegisterOf(tac->op1);
+                if (left < 0) {
+                    loadToW0(tac->op1, output);
+                    left = 0;
+                }
+                if (isConstant(tac->op2) && constantValue(tac->op2) >= 0 &&
+                    constantValue(tac->op2) < 4096) {
+                    output.format("\tcmp w%d, #%d\n", left, constantValue(tac->op2));
+                } else {
+                    int right = armRegisterOf(tac->op2);
+                    if (right < 0) {
+                        loadToW1(tac->op2, output);
+                        right = 1;
+                    }
+                    output.format("\tcmp w%d, w%d\n", left, right);
+                }
+                output.format("\tb.%s %s\n", cond, asmName(tac->res));
             }
             break;
 
         case TAC_JUMP:
             // goto res
             if (tac->res) {
-                fprintf(output, "\t// JUMP: goto %s\n", tac->res->text.c_str());
-                fprintf(output, "\tb %s\n", makeAsmName(tac->res->text).c_str());
+                if (!output.lean())
+                    output.note("\t// JUMP: goto %s\n", symbolName(tac->res).c_str());
+                output.format("\tb %s\n", asmName(tac->res));
             }
             break;
 
         case TAC_CALL:
             // res = call op1
             if (tac->res && tac->op1) {
-                fprintf(output, "\t// CALL %s = %s()\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str());
-                fprintf(output, "\tbl %s\n", makeFunctionName(tac->op1->text).c_str());
+                if (!output.lean())
+                    output.note("\t// CALL %s = %s()\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
+
+                // Os argumentos estão empilhados, o último no topo: os 8
+                // primeiros vão para w0..w7, os demais são lidos pelo chamado
+                std::vector<SymbolNode*> params;
+                collectParameters(tac->op1->parameterList, params);
+                int argCount = (int)params.size();
+                for (int i = 0; i < argCount && i < 8; i++) {
+                    output.format("\tldr w%d, [sp, #%d]\n", i, 16 * (argCount - 1 - i));
+                }
+
+                output.format("\tbl %s\n", makeFunctionName(symbolName(tac->op1)).c_str());
+                if (argCount > 0) {
+                    output.format("\tadd sp, sp, #%d\n", 16 * argCount);
+                }
                 storeW0To(tac->res, output);
             }
             break;
 
         case TAC_ARG:
-            // Argumento de função - usa registrador w0 (primeiro arg em ARM64)
+            // Argumento de função - empilhado até o TAC_CALL correspondente,
+            // pois avaliar os argumentos seguintes pode envolver outras chamadas
+            // (16 bytes por argumento mantêm sp alinhado)
             if (tac->res) {
-                fprintf(output, "\t// ARG %s\n", tac->res->text.c_str());
+                if (!output.lean())
+                    output.note("\t// ARG %s\n", symbolName(tac->res).c_str());
                 loadToW0(tac->res, output);
+                output.format("\tstr w0, [sp, #-16]!\n");
             }
             break;
 
         case TAC_RET:
             // return op1
-            fprintf(output, "\t// RET\n");
+            output.note("\t// RET\n");
             if (tac->op1) {
                 loadToW0(tac->op1, output);
             } else {
-                fprintf(output, "\tmov w0, #0\n");
+                output.format("\tmov w0, #0\n");
             }
-            fprintf(output, "\tldp x29, x30, [sp], #16\n");
-            fprintf(output, "\tret\n");
+            armEpilogue(output);
             break;
 
         case TAC_PRINT:
             // print op1
             if (tac->op1) {
-                fprintf(output, "\t// PRINT %s\n", tac->op1->text.c_str());
+                if (!output.lean())
+                    output.note("\t// PRINT %s\n", symbolName(tac->op1).c_str());
 
                 if (isStringLiteral(tac->op1)) {
                     // Print string - usar puts
-                    std::string name = makeAsmName(tac->op1->text);
-                    fprintf(output, "\tadrp x0, %s@PAGE\n", name.c_str());
-                    fprintf(output, "\tadd x0, x0, %s@PAGEOFF\n", name.c_str());
-                    fprintf(output, "\tbl _puts\n");
+                    const char* name = asmName(tac->op1);
+                    output.format("\tadrp x0, %s@PAGE\n", name);
+                    output.format("\tadd x0, x0, %s@PAGEOFF\n", name);
+                    output.format("\tbl _puts\n");
                 } else {
                     // Print inteiro - usar printf
                     // Em ARM64 macOS, argumentos variádicos são passados na pilha
                     // Alocar espaço na pilha para o argumento
-                    fprintf(output, "\tsub sp, sp, #16\n");
+                    output.format("\tsub sp, sp, #16\n");
 
                     // Carregar o valor para w8
-                    if (isIntLiteral(tac->op1)) {
-                        int val = atoi(tac->op1->text.c_str());
-                        fprintf(output, "\tmov w8, #%d\n", val);
-                    } else if (isCharLiteral(tac->op1)) {
-                        if (tac->op1->text.length() >= 3) {
-                            char c = tac->op1->text[1];
-                            fprintf(output, "\tmov w8, #%d\n", (int)c);
-                        } else {
-                            fprintf(output, "\tmov w8, #0\n");
-                        }
-                    } else if (isBoolLiteral(tac->op1)) {
-                        fprintf(output, "\tmov w8, #%d\n", tac->op1->text == "true" ? 1 : 0);
+                    if (isConstant(tac->op1)) {
+                        armLoadImmediate(8, constantValue(tac->op1), output);
+                    } else if (armRegisterOf(tac->op1) >= 0) {
+                        output.format("\tmov w8, w%d\n", armRegisterOf(tac->op1));
+                    } else if (armFrameOffset(tac->op1) > 0) {
+                        armFrameAccess(false, 8, armFrameOffset(tac->op1), 9, output);
                     } else {
-                        std::string name = makeAsmName(tac->op1->text);
-                        fprintf(output, "\tadrp x9, %s@PAGE\n", name.c_str());
-                        fprintf(output, "\tadd x9, x9, %s@PAGEOFF\n", name.c_str());
-                        fprintf(output, "\tldr w8, [x9]\n");
+                        const char* name = asmName(tac->op1);
+                        output.format("\tadrp x9, %s@PAGE\n", name);
+                        output.format("\tadd x9, x9, %s@PAGEOFF\n", name);
+                        output.format("\tldr w8, [x9]\n");
                     }
 
                     // Colocar argumento na pilha (estendido para 64-bit)
-                    fprintf(output, "\tstr x8, [sp]\n");
+                    output.format("\tstr x8, [sp]\n");
 
                     // Carregar formato em x0
-                    fprintf(output, "\tadrp x0, _printintln@PAGE\n");
-                    fprintf(output, "\tadd x0, x0, _printintln@PAGEOFF\n");
-                    fprintf(output, "\tbl _printf\n");
+                    output.format("\tadrp x0, _printintln@PAGE\n");
+                    output.format("\tadd x0, x0, _printintln@PAGEOFF\n");
+                    output.format("\tbl _printf\n");
 
                     // Restaurar pilha
-                    fprintf(output, "\tadd sp, sp, #16\n");
+                    output.format("\tadd sp, sp, #16\n");
                 }
             }
             break;
@@ -557,36 +715,43 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_READ:
             // read res
             if (tac->res) {
-                fprintf(output, "\t// READ %s\n", tac->res->text.c_str());
-                std::string name = makeAsmName(tac->res->text);
+                if (!output.lean())
+                    output.note("\t// READ %s\n", symbolName(tac->res).c_str());
+                const char* name = asmName(tac->res);
 
                 // Carregar formato em x0
-                fprintf(output, "\tadrp x0, _readint@PAGE\n");
-                fprintf(output, "\tadd x0, x0, _readint@PAGEOFF\n");
+                output.format("\tadrp x0, _readint@PAGE\n");
+                output.format("\tadd x0, x0, _readint@PAGEOFF\n");
                 // Carregar endereço da variável em x1
-                fprintf(output, "\tadrp x1, %s@PAGE\n", name.c_str());
-                fprintf(output, "\tadd x1, x1, %s@PAGEOFF\n", name.c_str());
-                fprintf(output, "\tbl _scanf\n");
+                if (armFrameOffset(tac->res) > 0) {
+                    output.format("\tmov x1, #%d\n", armFrameOffset(tac->res));
+                    output.format("\tsub x1, x29, x1\n");
+                } else {
+                    output.format("\tadrp x1, %s@PAGE\n", name);
+                    output.format("\tadd x1, x1, %s@PAGEOFF\n", name);
+                }
+                output.format("\tbl _scanf\n");
             }
             break;
 
         case TAC_VEC_ACCESS:
             // res = op1[op2]
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// VEC_ACCESS %s = %s[%s]\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// VEC_ACCESS %s = %s[%s]\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
 
                 // Carregar índice
                 loadToW0(tac->op2, output);
-                fprintf(output, "\tsxtw x0, w0\n");  // Sign extend to 64-bit
+                output.format("\tsxtw x0, w0\n");  // Sign extend to 64-bit
 
                 // Carregar endereço base do vetor
-                std::string vecName = makeAsmName(tac->op1->text);
-                fprintf(output, "\tadrp x1, %s@PAGE\n", vecName.c_str());
-                fprintf(output, "\tadd x1, x1, %s@PAGEOFF\n", vecName.c_str());
+                const char* vecName = asmName(tac->op1);
+                output.format("\tadrp x1, %s@PAGE\n", vecName);
+                output.format("\tadd x1, x1, %s@PAGEOFF\n", vecName);
 
                 // Acessar elemento: base + índice * 4
-                fprintf(output, "\tldr w0, [x1, x0, lsl #2]\n");
+                output.format("\tldr w0, [x1, x0, lsl #2]\n");
                 storeW0To(tac->res, output);
             }
             break;
@@ -594,33 +759,60 @@ static void generateTacAsm(TAC* tac, FILE* output) {
         case TAC_VEC_WRITE:
             // res[op1] = op2
             if (tac->res && tac->op1 && tac->op2) {
-                fprintf(output, "\t// VEC_WRITE %s[%s] = %s\n",
-                        tac->res->text.c_str(), tac->op1->text.c_str(), tac->op2->text.c_str());
+                if (!output.lean())
+                    output.note("\t// VEC_WRITE %s[%s] = %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
 
                 // Carregar índice
                 loadToW0(tac->op1, output);
-                fprintf(output, "\tsxtw x0, w0\n");  // Sign extend to 64-bit
+                output.format("\tsxtw x0, w0\n");  // Sign extend to 64-bit
 
                 // Carregar valor
                 loadToW1(tac->op2, output);
 
                 // Carregar endereço base do vetor
-                std::string vecName = makeAsmName(tac->res->text);
-                fprintf(output, "\tadrp x2, %s@PAGE\n", vecName.c_str());
-                fprintf(output, "\tadd x2, x2, %s@PAGEOFF\n", vecName.c_str());
+                const char* vecName = asmName(tac->res);
+                output.format("\tadrp x2, %s@PAGE\n", vecName);
+                output.format("\tadd x2, x2, %s@PAGEOFF\n", vecName);
 
                 // Escrever elemento: base + índice * 4
-                fprintf(output, "\tstr w1, [x2, x0, lsl #2]\n");
+                output.format("\tstr w1, [x2, x0, lsl #2]\n");
             }
             break;
 
         default:
-            fprintf(output, "\t// TAC DESCONHECIDO tipo=%d\n", tac->type);
+            output.note("\t// TAC DESCONHECIDO tipo=%d\n", tac->type);
             break;
     }
 }
 
-// Função auxiliar para coletar todos os símbolos usados
+// Função auxiliar para coletar os símbolos usados (TACs em ordem de execução)
+static void collectSymbols(const std::vector<TAC*>& tacs, std::vector<SymbolNode*>& symbols) {
+    std::unordered_set<SymbolNode*> seen;
+
+    for (TAC* t : tacs) {
+        auto addSymbol = [&](SymbolNode* sym) {
+            if (!sym) return;
+            if (isFunction(sym)) return;
+            if (isLabel(sym)) return;
+            if (!seen.insert(sym).second) return;
+            symbols.push_back(sym);
+        };
+
+        addSymbol(t->res);
+        addSymbol(t->op1);
+        addSymbol(t->op2);
+
+        // Parâmetros recebem valor no prólogo mesmo que não sejam usados
+        if (t->type == TAC_BEGINFUN && t->res) {
+            std::vector<SymbolNode*> params;
+            collectParameters(t->res->parameterList, params);
+            for (SymbolNode* param : params) addSymbol(param);
+        }
+    }
+}
+
+// Função auxiliar para coletar todos os símbolos usados (lista invertida)
 static void collectSymbols(TAC* tacList, std::vector<SymbolNode*>& symbols) {
     std::vector<TAC*> tacs;
     TAC* current = tacList;
@@ -628,125 +820,915 @@ static void collectSymbols(TAC* tacList, std::vector<SymbolNode*>& symbols) {
         tacs.push_back(current);
         current = current->prev;
     }
+    std::reverse(tacs.begin(), tacs.end());
+    collectSymbols(tacs, symbols);
+}
 
-    std::vector<std::string> seen;
+// Função auxiliar para separar os TACs (lista invertida) em ordem de execução:
+// inicializações globais (fora de funções) e código das funções
+static void splitTacs(TAC* tacList, std::vector<TAC*>& initTacs, std::vector<TAC*>& funcTacs) {
+    std::vector<TAC*> tacs;
+    TAC* current = tacList;
+    while (current) {
+        tacs.push_back(current);
+        current = current->prev;
+    }
 
+    bool inFunction = false;
     for (int i = tacs.size() - 1; i >= 0; i--) {
         TAC* t = tacs[i];
+        if (t->type == TAC_BEGINFUN) {
+            inFunction = true;
+        }
+        if (!inFunction) {
+            initTacs.push_back(t);
+        } else {
+            funcTacs.push_back(t);
+        }
+        if (t->type == TAC_ENDFUN) {
+            inFunction = false;
+        }
+    }
+}
 
-        auto addSymbol = [&](SymbolNode* sym) {
-            if (!sym) return;
-            if (isFunction(sym)) return;
-            if (isLabel(sym)) return;
+// Programa separado por função, com a alocação de registradores de cada uma
+struct AsmProgram {
+    std::vector<TAC*> initTacs;                  // Inicializações globais
+    std::vector<std::vector<TAC*>> functions;    // De TAC_BEGINFUN a TAC_ENDFUN
+    std::vector<RegAllocation> allocations;      // Alocação de cada função
+    std::unordered_set<SymbolNode*> locals;      // Símbolos em registradores ou no frame
+    int mainIndex;                               // Função que recebe as inicializações (-1 = nenhuma)
+
+    AsmProgram() : mainIndex(-1) {}
+};
+
+// Função auxiliar para verificar se a instrução inicia o main
+static bool isMainBegin(TAC* t) {
+    return t->type == TAC_BEGINFUN && t->res && t->res->text == "main";
+}
+
+// Função auxiliar para separar o programa em funções e alocar registradores
+// e slots de frame para os locais de cada uma (funções em paralelo no pool)
+static void prepareProgram(TAC* tacList, const RegisterSet& regs, ThreadPool& pool,
+                           AsmProgram& program) {
+    std::vector<TAC*> funcTacs;
+    splitTacs(tacList, program.initTacs, funcTacs);
 
-            for (const auto& s : seen) {
-                if (s == sym->text) return;
+    for (TAC* t : funcTacs) {
+        if (t->type == TAC_BEGINFUN || program.functions.empty()) {
+            program.functions.push_back(std::vector<TAC*>());
+        }
+        program.functions.back().push_back(t);
+    }
+
+    // As inicializações globais entram após o prólogo do primeiro main
+    for (size_t f = 0; f < program.functions.size() && program.mainIndex < 0; f++) {
+        for (TAC* t : program.functions[f]) {
+            if (isMainBegin(t)) {
+                program.mainIndex = (int)f;
+                break;
             }
-            seen.push_back(sym->text);
-            symbols.push_back(sym);
-        };
+        }
+    }
 
-        addSymbol(t->res);
-        addSymbol(t->op1);
-        addSymbol(t->op2);
+    std::unordered_set<SymbolNode*> addressTaken;
+    findLocalSymbols(program.initTacs, funcTacs, program.locals, addressTaken);
+
+    // Locais com o endereço tomado ficam sempre no frame
+    std::unordered_set<SymbolNode*> candidates;
+    for (SymbolNode* sym : program.locals) {
+        if (!addressTaken.count(sym)) candidates.insert(sym);
     }
+
+    program.allocations.resize(program.functions.size());
+    pool.parallelFor(program.functions.size(), [&](size_t f) {
+        allocateRegisters(program.functions[f], candidates, regs, program.allocations[f]);
+        assignFrameSlots(program.functions[f], program.locals, program.allocations[f]);
+    });
 }
 
-// Função principal para gerar código assembly
-void generateAsm(TAC* tacList, FILE* output) {
-    if (!output) return;
+// Número de funções geradas em paralelo antes de escrever seus buffers
+// (limita a memória ocupada pelo texto ainda não escrito)
+static const size_t EMIT_BATCH = 256;
+
+// Gera o código de cada função em um buffer próprio (em paralelo no pool) e
+// escreve os buffers no arquivo na ordem do fonte, de modo que a saída não
+// depende do número de threads
+static void emitFunctions(const AsmProgram& program, ThreadPool& pool, FILE* file, bool lean,
+                          void (*emitFunction)(const AsmProgram&, size_t, AsmEmitter&)) {
+    size_t count = program.functions.size();
+    std::vector<std::unique_ptr<AsmEmitter>> buffers;
+
+    for (size_t first = 0; first < count; first += EMIT_BATCH) {
+        size_t batch = std::min(EMIT_BATCH, count - first);
+        buffers.resize(batch);
+        for (size_t i = 0; i < batch; i++) {
+            if (!buffers[i]) buffers[i].reset(new AsmEmitter(lean));
+        }
+
+        pool.parallelFor(batch, [&](size_t i) {
+            emitFunction(program, first + i, *buffers[i]);
+        });
 
+        for (size_t i = 0; i < batch; i++) {
+            buffers[i]->flush(file);
+        }
+    }
+}
+
+// Função auxiliar para alocar registradores e slots de frame de uma única
+// função (compilação em fluxo): sem ver o resto do programa, só são locais
+// os temporários e os símbolos declarados pela própria função (ownSymbols)
+static void prepareFunction(const std::vector<TAC*>& funcTacs,
+                            const std::unordered_set<SymbolNode*>& ownSymbols,
+                            const RegisterSet& regs, std::unordered_set<SymbolNode*>& locals,
+                            RegAllocation& allocation) {
+    std::unordered_set<SymbolNode*> found, addressTaken;
+    findLocalSymbols(std::vector<TAC*>(), funcTacs, found, addressTaken);
+
+    std::unordered_set<SymbolNode*> candidates;
+    for (SymbolNode* sym : found) {
+        if (sym->type != SYMBOL_TEMP && !ownSymbols.count(sym)) continue;
+        locals.insert(sym);
+        if (!addressTaken.count(sym)) candidates.insert(sym);
+    }
+
+    allocateRegisters(funcTacs, candidates, regs, allocation);
+    assignFrameSlots(funcTacs, locals, allocation);
+}
+
+// Cabeçalho do arquivo ARM64 e formatos usados por printf/scanf
+static void armHeader(AsmEmitter& output) {
+    output.format("// Código assembly gerado pelo compilador\n");
+    output.format("// Etapa 7 - Compiladores UFRGS 2025/2\n");
+    output.format("// Autor: Santiago Gonzaga\n");
+    output.format("// Arquitetura: ARM64 (Apple Silicon / macOS)\n\n");
+
+    generateDataSection(output);
+}
+
+// Declara na seção .data um símbolo que vive em memória
+static void armDataSymbol(SymbolNode* sym, AsmEmitter& output) {
+    std::string name = makeAsmName(symbolName(sym));
+
+    if (isStringLiteral(sym)) {
+        output.format("%s:\n", name.c_str());
+        output.format("\t.asciz %s\n", sym->text.c_str());
+    } else if (sym->nature == NATURE_VECTOR) {
+        // Vetor ocupa 4 bytes por elemento
+        output.format("\t.p2align 2\n");
+        output.format("%s:\n", name.c_str());
+        output.format("\t.space %d\n", 4 * vectorLength(sym));
+    } else {
+        output.format("%s:\n", name.c_str());
+        output.format("\t.long 0\n");
+    }
+}
+
+// Gera o código de uma função ARM64, inserindo as inicializações globais
+// após o prólogo do main
+static void armFunction(const AsmProgram& program, size_t f, AsmEmitter& output) {
+    asmNames.clear();
+    armAlloc = &program.allocations[f];
+    for (TAC* t : program.functions[f]) {
+        generateTacAsm(t, output);
+
+        if ((int)f == program.mainIndex && isMainBegin(t) && !program.initTacs.empty()) {
+            output.note("\t// Inicialização de variáveis globais\n");
+            for (TAC* init : program.initTacs) {
+                generateTacAsm(init, output);
+            }
+        }
+    }
+    armAlloc = nullptr;
+}
+
+// Função principal do backend ARM64
+static void generateAsmArm64(TAC* tacList, FILE* file, ThreadPool& pool, bool lean) {
     // Resetar contadores globais
     stringCounter = 0;
     stringNames.clear();
 
-    fprintf(output, "// Código assembly gerado pelo compilador\n");
-    fprintf(output, "// Etapa 6 - Compiladores UFRGS 2025/2\n");
-    fprintf(output, "// Autor: Santiago Gonzaga\n");
-    fprintf(output, "// Arquitetura: ARM64 (Apple Silicon / macOS)\n\n");
+    // Separar funções e alocar registradores
+    AsmProgram program;
+    timingBegin("alocacao de registradores");
+    prepareProgram(tacList, armRegisters, pool, program);
+    timingEnd();
 
-    // Gerar seção de dados
-    generateDataSection(output);
+    // Gerar cabeçalho e seção de dados
+    AsmEmitter output(lean);
+    armHeader(output);
 
     // Coletar símbolos usados
     std::vector<SymbolNode*> symbols;
     collectSymbols(tacList, symbols);
 
     // Declarar variáveis e literais na seção .data
-    fprintf(output, "// Declaração de variáveis e literais\n");
+    output.format("// Declaração de variáveis e literais\n");
     for (SymbolNode* sym : symbols) {
         if (!sym) continue;
+        if (program.locals.count(sym)) continue;
+        if (isConstant(sym)) continue;
+        armDataSymbol(sym, output);
+    }
+
+    output.format("\n");
+
+    // Gerar seção de código
+    output.format("// Seção de código\n");
+    output.format(".text\n\n");
+    output.flush(file);
+
+    // Gerar código das funções
+    emitFunctions(program, pool, file, lean, armFunction);
+
+    output.format("\n// Fim do código assembly\n");
+    output.flush(file);
+}
+
+
+// ==================== BACKEND x86-64 (Linux / System V) ====================
+
+// Registradores de argumentos inteiros da System V AMD64 ABI (32 bits)
+static const char* x86ArgRegs[6] = {"%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d"};
+
+// Quantidade de slots de 8 bytes empilhados por TAC_ARG ainda não consumidos
+// por um TAC_CALL (necessário para manter a pilha alinhada em 16 bytes)
+static thread_local int x86PendingArgs = 0;
+
+// Nome de função no ELF - main deve manter o nome para o crt0 do Linux
+static std::string makeX86FunctionName(const std::string& name) {
+    if (name == "main") return name;
+    return makeFunctionName(name);
+}
+
+// Registradores usados pelo alocador: índices 0..4 preservados entre
+// chamadas, 5..10 destruídos por chamadas (%eax, %ecx e %edx ficam livres
+// como registradores de trabalho)
+static const RegisterSet x86Registers = {5, 6};
+static const char* x86RegNames[11] = {
+    "%ebx", "%r12d", "%r13d", "%r14d", "%r15d",
+    "%esi", "%edi", "%r8d", "%r9d", "%r10d", "%r11d"
+};
+static const char* x86CalleeSaved64[5] = {"%rbx", "%r12", "%r13", "%r14", "%r15"};
+
+// Alocação de registradores da função sendo gerada (uma por thread)
+static thread_local const RegAllocation* x86Alloc = nullptr;
+
+// Operando AT&T para um símbolo: imediato, registrador ou memória
+static std::string makeX86Operand(SymbolNode* sym) {
+    if (isConstant(sym)) {
+        return "$" + std::to_string(constantValue(sym));
+    }
+
+    int reg = x86Alloc ? x86Alloc->location(sym) : -1;
+    if (reg >= 0) return x86RegNames[reg];
+
+    // Local no frame - abaixo dos registradores preservados salvos
+    int slot = x86Alloc ? x86Alloc->frameSlot(sym) : 0;
+    if (slot > 0) {
+        int offset = 8 * (int)x86Alloc->calleeSavedUsed.size() + slot;
+        return "-" + std::to_string(offset) + "(%rbp)";
+    }
+
+    // Variável - acesso relativo ao RIP (executáveis PIE)
+    return std::string(asmName(sym)) + "(%rip)";
+}
+
+// Operandos já calculados na função sendo gerada (fixos durante a função)
+static thread_local std::unordered_map<SymbolNode*, std::string> x86Operands;
 
-        std::string name = makeAsmName(sym->text);
+static const char* x86Operand(SymbolNode* sym) {
+    if (!sym) return "$0";
 
-        if (isIntLiteral(sym) || isCharLiteral(sym) || isBoolLiteral(sym)) {
-            continue;
+    std::string& operand = x86Operands[sym];
+    if (operand.empty()) operand = makeX86Operand(sym);
+    return operand.c_str();
+}
+
+// Tamanho do frame abaixo de %rbp: registradores preservados salvos e slots
+// dos locais que ficaram em memória (múltiplo de 16)
+static int x86FrameSize() {
+    if (!x86Alloc) return 0;
+    int bytes = 8 * (int)x86Alloc->calleeSavedUsed.size() + x86Alloc->frameBytes;
+    return (bytes + 15) / 16 * 16;
+}
+
+// Epílogo: restaura registradores preservados e retorna
+static void x86Epilogue(AsmEmitter& output) {
+    if (x86Alloc) {
+        for (size_t i = 0; i < x86Alloc->calleeSavedUsed.size(); i++) {
+            output.format("\tmovq -%d(%%rbp), %s\n", (int)(8 * (i + 1)),
+                    x86CalleeSaved64[x86Alloc->calleeSavedUsed[i]]);
         }
+    }
+    output.format("\tleave\n");
+    output.format("\tret\n");
+}
 
-        if (isStringLiteral(sym)) {
-            fprintf(output, "%s:\n", name.c_str());
-            fprintf(output, "\t.asciz %s\n", sym->text.c_str());
-        } else {
-            fprintf(output, "%s:\n", name.c_str());
-            fprintf(output, "\t.long 0\n");
+// Função auxiliar para carregar valor em um registrador de 32 bits
+static void x86LoadTo(SymbolNode* sym, const char* reg, AsmEmitter& output) {
+    if (!sym) {
+        output.format("\txorl %s, %s\n", reg, reg);
+        return;
+    }
+
+    const char* operand = x86Operand(sym);
+    if (strcmp(operand, reg) != 0) {
+        output.format("\tmovl %s, %s\n", operand, reg);
+    }
+}
+
+// Função auxiliar para armazenar %eax em variável
+static void x86StoreEax(SymbolNode* sym, AsmEmitter& output) {
+    if (!sym) return;
+    output.format("\tmovl %%eax, %s\n", x86Operand(sym));
+}
+
+// Chamada a função da libc mantendo a pilha alinhada em 16 bytes
+static void x86CallLibc(const char* func, AsmEmitter& output) {
+    bool pad = (x86PendingArgs % 2) != 0;
+    if (pad) output.format("\tsubq $8, %%rsp\n");
+    output.format("\tcall %s@PLT\n", func);
+    if (pad) output.format("\taddq $8, %%rsp\n");
+}
+
+// Operação binária: %eax = op1 <op> op2
+static void x86BinOp(TAC* tac, const char* name, const char* symbol, const char* instr, AsmEmitter& output) {
+    if (!output.lean())
+        output.note("\t# %s %s = %s %s %s\n", name,
+                symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbol, symbolName(tac->op2).c_str());
+    x86LoadTo(tac->op1, "%eax", output);
+    output.format("\t%s %s, %%eax\n", instr, x86Operand(tac->op2));
+    x86StoreEax(tac->res, output);
+}
+
+// Comparação: %eax = (op1 <cc> op2) ? 1 : 0
+static void x86Compare(TAC* tac, const char* name, const char* symbol, const char* cc, AsmEmitter& output) {
+    if (!output.lean())
+        output.note("\t# %s %s = %s %s %s\n", name,
+                symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbol, symbolName(tac->op2).c_str());
+    x86LoadTo(tac->op1, "%eax", output);
+    output.format("\tcmpl %s, %%eax\n", x86Operand(tac->op2));
+    output.format("\tset%s %%al\n", cc);
+    output.format("\tmovzbl %%al, %%eax\n");
+    x86StoreEax(tac->res, output);
+}
+
+// Função para gerar uma instrução TAC em assembly x86-64
+static void generateTacX86(TAC* tac, AsmEmitter& output) {
+    if (!tac) return;
+
+    bool hasOperands = tac->res && tac->op1 && tac->op2;
+
+    switch(tac->type) {
+        case TAC_SYMBOL:
+            // Não gera código
+            break;
+
+        case TAC_MOVE:
+            // res = op1
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# MOVE %s = %s\n", symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                x86StoreEax(tac->res, output);
+            }
+            break;
+
+        case TAC_ADD: if (hasOperands) x86BinOp(tac, "ADD", "+", "addl", output); break;
+        case TAC_SUB: if (hasOperands) x86BinOp(tac, "SUB", "-", "subl", output); break;
+        case TAC_MUL: if (hasOperands) x86BinOp(tac, "MUL", "*", "imull", output); break;
+        case TAC_AND: if (hasOperands) x86BinOp(tac, "AND", "&", "andl", output); break;
+        case TAC_OR:  if (hasOperands) x86BinOp(tac, "OR", "|", "orl", output); break;
+
+        case TAC_DIV:
+        case TAC_MOD:
+            // res = op1 / op2 (quociente em %eax, resto em %edx)
+            if (hasOperands) {
+                if (!output.lean())
+                    output.note("\t# %s %s = %s %s %s\n", tac->type == TAC_DIV ? "DIV" : "MOD",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(),
+                            tac->type == TAC_DIV ? "/" : "%", symbolName(tac->op2).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                x86LoadTo(tac->op2, "%ecx", output);
+                output.format("\tcltd\n");
+                output.format("\tidivl %%ecx\n");
+                if (tac->type == TAC_MOD) {
+                    output.format("\tmovl %%edx, %%eax\n");
+                }
+                x86StoreEax(tac->res, output);
+            }
+            break;
+
+        case TAC_LT:  if (hasOperands) x86Compare(tac, "LT", "<", "l", output); break;
+        case TAC_GT:  if (hasOperands) x86Compare(tac, "GT", ">", "g", output); break;
+        case TAC_LE:  if (hasOperands) x86Compare(tac, "LE", "<=", "le", output); break;
+        case TAC_GE:  if (hasOperands) x86Compare(tac, "GE", ">=", "ge", output); break;
+        case TAC_EQ:  if (hasOperands) x86Compare(tac, "EQ", "==", "e", output); break;
+        case TAC_DIF: if (hasOperands) x86Compare(tac, "DIF", "!=", "ne", output); break;
+
+        case TAC_NOT:
+            // res = !op1
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# NOT %s = ~%s\n", symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                output.format("\ttestl %%eax, %%eax\n");
+                output.format("\tsete %%al\n");
+                output.format("\tmovzbl %%al, %%eax\n");
+                x86StoreEax(tac->res, output);
+            }
+            break;
+
+        case TAC_NEG:
+            // res = -op1
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# NEG %s = -%s\n", symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                output.format("\tnegl %%eax\n");
+                x86StoreEax(tac->res, output);
+            }
+            break;
+
+        case TAC_LABEL:
+            // Label para desvios
+            if (tac->res) {
+                output.format("%s:\n", asmName(tac->res));
+            }
+            break;
+
+        case TAC_BEGINFUN:
+            // Início de função
+            if (tac->res) {
+                std::string funcName = makeX86FunctionName(symbolName(tac->res));
+                if (!output.lean())
+                    output.note("\n# Função %s\n", symbolName(tac->res).c_str());
+                output.format("\t.globl %s\n", funcName.c_str());
+                output.format("\t.type %s, @function\n", funcName.c_str());
+                output.format("%s:\n", funcName.c_str());
+                // Prólogo - após o push a pilha fica alinhada em 16 bytes
+                output.format("\tpushq %%rbp\n");
+                output.format("\tmovq %%rsp, %%rbp\n");
+                x86PendingArgs = 0;
+
+                // Reservar o frame e salvar os registradores preservados usados
+                if (x86FrameSize() > 0) {
+                    output.format("\tsubq $%d, %%rsp\n", x86FrameSize());
+                    for (size_t i = 0; i < x86Alloc->calleeSavedUsed.size(); i++) {
+                        output.format("\tmovq %s, -%d(%%rbp)\n",
+                                x86CalleeSaved64[x86Alloc->calleeSavedUsed[i]], (int)(8 * (i + 1)));
+                    }
+                }
+
+                // Salvar parâmetros: os 6 primeiros chegam em registradores,
+                // os demais na pilha do chamador (acima do endereço de retorno)
+                std::vector<SymbolNode*> params;
+                collectParameters(tac->res->parameterList, params);
+                for (size_t i = 0; i < params.size(); i++) {
+                    if (!output.lean())
+                        output.note("\t# Salvando parâmetro %s\n", params[i]->text.c_str());
+                    if (i < 6) {
+                        output.format("\tmovl %s, %s\n", x86ArgRegs[i], x86Operand(params[i]));
+                    } else {
+                        output.format("\tmovl %d(%%rbp), %%eax\n", (int)(16 + 8 * (i - 6)));
+                        x86StoreEax(params[i], output);
+                    }
+                }
+            }
+            break;
+
+        case TAC_ENDFUN:
+            // Fim de função
+            if (tac->res) {
+                if (!output.lean())
+                    output.note("\t# Fim da função %s\n", symbolName(tac->res).c_str());
+                output.format("\txorl %%eax, %%eax\n");
+                x86Epilogue(output);
+                output.format("\t.size %s, .-%s\n",
+                        makeX86FunctionName(symbolName(tac->res)).c_str(),
+                        makeX86FunctionName(symbolName(tac->res)).c_str());
+            }
+            break;
+
+        case TAC_IFZ:
+            // if op1 == 0 goto res
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# IFZ: if %s == 0 goto %s\n",
+                            symbolName(tac->op1).c_str(), symbolName(tac->res).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                output.format("\ttestl %%eax, %%eax\n");
+                output.format("\tje %s\n", asmName(tac->res));
+            }
+            break;
+
+        case TAC_IFNZ:
+            // if op1 != 0 goto res
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# IFNZ: if %s != 0 goto %s\n",
+                            symbolName(tac->op1).c_str(), symbolName(tac->res).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                output.format("\ttestl %%eax, %%eax\n");
+                output.format("\tjne %s\n", asmName(tac->res));
+            }
+            break;
+
+        case TAC_JLT:
+        case TAC_JGT:
+        case TAC_JLE:
+        case TAC_JGE:
+        case TAC_JEQ:
+        case TAC_JNE:
+            // if op1 <cond> op2 goto res - uma comparação e um desvio
+            if (hasOperands) {
+                const char* cc = "e";
+                const char* symbol = "==";
+                switch (tac->type) {
+                    case TAC_JLT: cc = "l"; symbol = "<"; break;
+                    case TAC_JGT: cc = "g"; symbol = ">"; break;
+                    case TAC_JLE: cc = "le"; symbol = "<="; break;
+                    case TAC_JGE: cc = "ge"; symbol = ">="; break;
+                    case TAC_JEQ: cc = "e"; symbol = "=="; break;
+                    case TAC_JNE: cc = "ne"; symbol = "!="; break;
+                }
+                if (!output.lean())
+                    output.note("\t# %s: if %s %s %s goto %s\n", tacTypeName(tac->type) + 4,
+                            symbolName(tac->op1).c_str(), symbol, symbolName(tac->op2).c_str(), symbolName(tac->res).c_str());
+                // Operando em registrador alocado é comparado diretamente
+                std::string left = x86Operand(tac->op1);
+                if (left[0] != '%') {
+                    x86LoadTo(tac->op1, "%eax", output);
+                    left = "%eax";
+                }
+                output.format("\tcmpl %s, %s\n", x86Operand(tac->op2), left.c_str());
+                output.format("\tj%s %s\n", cc, asmName(tac->res));
+            }
+            break;
+
+        case TAC_JUMP:
+            // goto res
+            if (tac->res) {
+                if (!output.lean())
+                    output.note("\t# JUMP: goto %s\n", symbolName(tac->res).c_str());
+                output.format("\tjmp %s\n", asmName(tac->res));
+            }
+            break;
+
+        case TAC_ARG:
+            // Argumento de função - empilhado até o TAC_CALL correspondente,
+            // pois avaliar os argumentos seguintes pode envolver outras chamadas
+            if (tac->res) {
+                if (!output.lean())
+                    output.note("\t# ARG %s\n", symbolName(tac->res).c_str());
+                x86LoadTo(tac->res, "%eax", output);
+                output.format("\tpushq %%rax\n");
+                x86PendingArgs++;
+            }
+            break;
+
+        case TAC_CALL:
+            // res = call op1
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# CALL %s = %s()\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
+
+                std::vector<SymbolNode*> params;
+                collectParameters(tac->op1->parameterList, params);
+                int argCount = (int)params.size();
+                int stackArgs = argCount > 6 ? argCount - 6 : 0;
+
+                // Alinhar a pilha considerando os argumentos ainda pendentes
+                // e as cópias dos argumentos passados em memória
+                bool pad = ((x86PendingArgs + stackArgs) % 2) != 0;
+                if (pad) output.format("\tsubq $8, %%rsp\n");
+
+                // Argumentos além do sexto: copiar em ordem inversa, de modo que
+                // o sétimo fique no topo da pilha no momento da chamada
+                int base = pad ? 8 : 0;
+                for (int i = argCount - 1; i >= 6; i--) {
+                    int offset = 8 * (argCount - 1 - i) + base + 8 * (argCount - 1 - i);
+                    output.format("\tpushq %d(%%rsp)\n", offset);
+                }
+
+                // Seis primeiros argumentos em registradores
+                for (int i = 0; i < argCount && i < 6; i++) {
+                    int offset = 8 * (argCount - 1 - i) + base + 8 * stackArgs;
+                    output.format("\tmovl %d(%%rsp), %s\n", offset, x86ArgRegs[i]);
+                }
+
+                output.format("\tcall %s\n", makeX86FunctionName(symbolName(tac->op1)).c_str());
+
+                int release = 8 * (argCount + stackArgs) + base;
+                if (release > 0) output.format("\taddq $%d, %%rsp\n", release);
+                x86PendingArgs -= argCount;
+                x86StoreEax(tac->res, output);
+            }
+            break;
+
+        case TAC_RET:
+            // return op1
+            output.note("\t# RET\n");
+            x86LoadTo(tac->op1, "%eax", output);
+            x86Epilogue(output);
+            break;
+
+        case TAC_PRINT:
+            // print op1
+            if (tac->op1) {
+                if (!output.lean())
+                    output.note("\t# PRINT %s\n", symbolName(tac->op1).c_str());
+
+                if (isStringLiteral(tac->op1)) {
+                    // Print string - usar puts
+                    output.format("\tleaq %s(%%rip), %%rdi\n", asmName(tac->op1));
+                    x86CallLibc("puts", output);
+                } else {
+                    // Print inteiro - usar printf (variádica: %al = 0 registradores vetoriais)
+                    x86LoadTo(tac->op1, "%esi", output);
+                    output.format("\tleaq _printintln(%%rip), %%rdi\n");
+                    output.format("\txorl %%eax, %%eax\n");
+                    x86CallLibc("printf", output);
+                }
+            }
+            break;
+
+        case TAC_READ:
+            // read res
+            if (tac->res) {
+                if (!output.lean())
+                    output.note("\t# READ %s\n", symbolName(tac->res).c_str());
+                output.format("\tleaq _readint(%%rip), %%rdi\n");
+                output.format("\tleaq %s, %%rsi\n", x86Operand(tac->res));
+                output.format("\txorl %%eax, %%eax\n");
+                x86CallLibc("__isoc99_scanf", output);
+            }
+            break;
+
+        case TAC_VEC_ACCESS:
+            // res = op1[op2]
+            if (hasOperands) {
+                if (!output.lean())
+                    output.note("\t# VEC_ACCESS %s = %s[%s]\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
+                x86LoadTo(tac->op2, "%eax", output);
+                output.format("\tcltq\n");  // Estender índice para 64 bits
+                output.format("\tleaq %s(%%rip), %%rcx\n", asmName(tac->op1));
+                output.format("\tmovl (%%rcx,%%rax,4), %%eax\n");
+                x86StoreEax(tac->res, output);
+            }
+            break;
+
+        case TAC_VEC_WRITE:
+            // res[op1] = op2
+            if (hasOperands) {
+                if (!output.lean())
+                    output.note("\t# VEC_WRITE %s[%s] = %s\n",
+                            symbolName(tac->res).c_str(), symbolName(tac->op1).c_str(), symbolName(tac->op2).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                output.format("\tcltq\n");
+                x86LoadTo(tac->op2, "%edx", output);
+                output.format("\tleaq %s(%%rip), %%rcx\n", asmName(tac->res));
+                output.format("\tmovl %%edx, (%%rcx,%%rax,4)\n");
+            }
+            break;
+
+        case TAC_VEC_READ:
+            // res[op1] = input
+            if (tac->res && tac->op1) {
+                if (!output.lean())
+                    output.note("\t# VEC_READ %s[%s]\n", symbolName(tac->res).c_str(), symbolName(tac->op1).c_str());
+                x86LoadTo(tac->op1, "%eax", output);
+                output.format("\tcltq\n");
+                output.format("\tleaq %s(%%rip), %%rsi\n", asmName(tac->res));
+                output.format("\tleaq (%%rsi,%%rax,4), %%rsi\n");
+                output.format("\tleaq _readint(%%rip), %%rdi\n");
+                output.format("\txorl %%eax, %%eax\n");
+                x86CallLibc("__isoc99_scanf", output);
+            }
+            break;
+
+        default:
+            output.note("\t# TAC DESCONHECIDO tipo=%d\n", tac->type);
+            break;
+    }
+}
+
+// Cabeçalho do arquivo x86-64 e formatos usados por printf/scanf
+static void x86Header(AsmEmitter& output) {
+    output.format("# Código assembly gerado pelo compilador\n");
+    output.format("# Etapa 7 - Compiladores UFRGS 2025/2\n");
+    output.format("# Autor: Santiago Gonzaga\n");
+    output.format("# Arquitetura: x86-64 (Linux / System V, sintaxe AT&T)\n\n");
+
+    // Seção de dados - formatos usados por printf/scanf
+    output.format("# Seção de dados\n");
+    output.format("\t.data\n\n");
+    output.format("_printintln:\n");
+    output.format("\t.asciz \"%%d\\n\"\n\n");
+    output.format("_readint:\n");
+    output.format("\t.asciz \"%%d\"\n\n");
+}
+
+// Declara na seção .data um símbolo que vive em memória
+static void x86DataSymbol(SymbolNode* sym, AsmEmitter& output) {
+    std::string name = makeAsmName(symbolName(sym));
+
+    if (isStringLiteral(sym)) {
+        output.format("%s:\n", name.c_str());
+        output.format("\t.asciz %s\n", sym->text.c_str());
+    } else if (sym->nature == NATURE_VECTOR) {
+        output.format("\t.balign 4\n");
+        output.format("%s:\n", name.c_str());
+        output.format("\t.zero %d\n", 4 * vectorLength(sym));
+    } else {
+        output.format("\t.balign 4\n");
+        output.format("%s:\n", name.c_str());
+        output.format("\t.long 0\n");
+    }
+}
+
+// Gera o código de uma função x86-64, inserindo as inicializações globais
+// após o prólogo do main
+static void x86Function(const AsmProgram& program, size_t f, AsmEmitter& output) {
+    asmNames.clear();
+    x86Operands.clear();
+    x86Alloc = &program.allocations[f];
+    x86PendingArgs = 0;
+    for (TAC* t : program.functions[f]) {
+        generateTacX86(t, output);
+
+        if ((int)f == program.mainIndex && isMainBegin(t) && !program.initTacs.empty()) {
+            output.note("\t# Inicialização de variáveis globais\n");
+            for (TAC* init : program.initTacs) {
+                generateTacX86(init, output);
+            }
         }
     }
+    x86Alloc = nullptr;
+}
+
+// Função principal do backend x86-64
+static void generateAsmX86(TAC* tacList, FILE* file, ThreadPool& pool, bool lean) {
+    // Resetar contadores globais
+    stringCounter = 0;
+    stringNames.clear();
+    x86PendingArgs = 0;
+
+    AsmEmitter output(lean);
+    x86Header(output);
 
-    fprintf(output, "\n");
+    // Separar funções e alocar registradores
+    AsmProgram program;
+    timingBegin("alocacao de registradores");
+    prepareProgram(tacList, x86Registers, pool, program);
+    timingEnd();
+
+    // Coletar símbolos usados
+    std::vector<SymbolNode*> symbols;
+    collectSymbols(tacList, symbols);
+
+    // Declarar variáveis e literais na seção .data
+    output.format("# Declaração de variáveis e literais\n");
+    for (SymbolNode* sym : symbols) {
+        if (!sym) continue;
+        if (program.locals.count(sym)) continue;
+        if (isConstant(sym)) continue;
+        x86DataSymbol(sym, output);
+    }
 
     // Gerar seção de código
-    fprintf(output, "// Seção de código\n");
-    fprintf(output, ".text\n\n");
+    output.format("\n# Seção de código\n");
+    output.format("\t.text\n");
+    output.flush(file);
 
-    // Coletar todos os TACs em ordem correta
-    std::vector<TAC*> tacs;
-    TAC* current = tacList;
-    while (current) {
-        tacs.push_back(current);
-        current = current->prev;
+    // Gerar código das funções
+    emitFunctions(program, pool, file, lean, x86Function);
+
+    // Pilha não executável
+    output.format("\n\t.section .note.GNU-stack,\"\",@progbits\n");
+    output.format("\n# Fim do código assembly\n");
+    output.flush(file);
+}
+
+// Função principal para gerar código assembly
+void generateAsm(TAC* tacList, FILE* output, int target, ThreadPool& pool, bool lean) {
+    if (!output) return;
+
+    if (target == ASM_TARGET_X86_64) {
+        generateAsmX86(tacList, output, pool, lean);
+    } else {
+        generateAsmArm64(tacList, output, pool, lean);
     }
+}
 
-    // Separar TACs de inicialização global (antes de BEGINFUN) e o resto
-    std::vector<TAC*> initTacs;
-    std::vector<TAC*> funcTacs;
-    bool inFunction = false;
-    bool foundMain = false;
+// ==================== GERAÇÃO EM FLUXO ====================
 
-    for (int i = tacs.size() - 1; i >= 0; i--) {
-        TAC* t = tacs[i];
-        if (t->type == TAC_BEGINFUN) {
-            inFunction = true;
-            if (t->res && t->res->text == "main") {
-                foundMain = true;
-            }
+// Símbolos já declarados na seção .data do arquivo em geração
+static std::unordered_set<SymbolNode*> streamData;
+static bool streamLean = false;
+
+void generateAsmBegin(FILE* file, int target, bool lean) {
+    if (!file) return;
+
+    stringCounter = 0;
+    stringNames.clear();
+    x86PendingArgs = 0;
+    streamData.clear();
+    streamLean = lean;
+
+    AsmEmitter output(lean);
+    if (target == ASM_TARGET_X86_64) {
+        x86Header(output);
+    } else {
+        armHeader(output);
+    }
+    output.flush(file);
+}
+
+void generateAsmGlobal(SymbolNode* sym, const std::vector<SymbolNode*>& initialValues,
+                       FILE* file, int target) {
+    if (!file || !sym || !streamData.insert(sym).second) return;
+
+    bool x86 = target == ASM_TARGET_X86_64;
+    int length = sym->nature == NATURE_VECTOR ? vectorLength(sym) : 1;
+
+    AsmEmitter output(streamLean);
+    output.format(x86 ? "\n\t.data\n\t.balign 4\n" : "\n.data\n\t.p2align 2\n");
+    output.format("%s:\n", asmName(sym));
+
+    // Valores conhecidos em tempo de compilação; literais float valem 0,
+    // como na inicialização feita no início do main
+    int count = 0;
+    for (SymbolNode* value : initialValues) {
+        if (count == length) break;
+        output.format("\t.long %d\n", isConstant(value) ? constantValue(value) : 0);
+        count++;
+    }
+    if (count < length) {
+        output.format(x86 ? "\t.zero %d\n" : "\t.space %d\n", 4 * (length - count));
+    }
+    output.flush(file);
+}
+
+void generateAsmFunction(const std::vector<TAC*>& funcTacs,
+                         const std::unordered_set<SymbolNode*>& ownSymbols,
+                         FILE* file, int target) {
+    if (!file || funcTacs.empty()) return;
+
+    bool x86 = target == ASM_TARGET_X86_64;
+    RegAllocation allocation;
+    std::unordered_set<SymbolNode*> locals;
+    prepareFunction(funcTacs, ownSymbols, x86 ? x86Registers : armRegisters, locals, allocation);
+
+    // Literais e variáveis em memória usados pela primeira vez nesta função
+    std::vector<SymbolNode*> symbols;
+    collectSymbols(funcTacs, symbols);
+
+    AsmEmitter output(streamLean);
+    bool dataOpened = false;
+    for (SymbolNode* sym : symbols) {
+        if (locals.count(sym) || isConstant(sym)) continue;
+        if (!streamData.insert(sym).second) continue;
+
+        if (!dataOpened) {
+            output.format(x86 ? "\n\t.data\n" : "\n.data\n");
+            dataOpened = true;
         }
-        if (!inFunction) {
-            initTacs.push_back(t);
+        if (x86) {
+            x86DataSymbol(sym, output);
         } else {
-            funcTacs.push_back(t);
-        }
-        if (t->type == TAC_ENDFUN) {
-            inFunction = false;
+            armDataSymbol(sym, output);
         }
     }
 
-    // Gerar código das funções, inserindo inicializações no início do main
-    bool mainPrologueDone = false;
-    for (size_t i = 0; i < funcTacs.size(); i++) {
-        TAC* t = funcTacs[i];
-        generateTacAsm(t, output);
-
-        // Após o prólogo do main, inserir código de inicialização global
-        if (t->type == TAC_BEGINFUN && t->res && t->res->text == "main" && !mainPrologueDone) {
-            mainPrologueDone = true;
-            if (!initTacs.empty()) {
-                fprintf(output, "\t// Inicialização de variáveis globais\n");
-                for (size_t j = 0; j < initTacs.size(); j++) {
-                    generateTacAsm(initTacs[j], output);
-                }
-            }
-        }
+    output.format(x86 ? "\n\t.text\n" : "\n.text\n");
+    asmNames.clear();
+    x86Operands.clear();
+    if (x86) {
+        x86Alloc = &allocation;
+        for (TAC* t : funcTacs) generateTacX86(t, output);
+        x86Alloc = nullptr;
+    } else {
+        armAlloc = &allocation;
+        for (TAC* t : funcTacs) generateTacAsm(t, output);
+        armAlloc = nullptr;
     }
+    output.flush(file);
+}
 
-    fprintf(output, "\n// Fim do código assembly\n");
+void generateAsmEnd(FILE* file, int target) {
+    if (!file) return;
+
+    AsmEmitter output(streamLean);
+    if (target == ASM_TARGET_X86_64) {
+        output.format("\n\t.section .note.GNU-stack,\"\",@progbits\n");
+        output.format("\n# Fim do código assembly\n");
+    } else {
+        output.format("\n// Fim do código assembly\n");
+    }
+    output.flush(file);
 }
@@ -1,8 +1,9 @@
 /*
- * Compiladores - etapa6 - asm.hpp - semestre 2025/2
+ * Compiladores - etapa7 - asm.hpp - semestre 2025/2
  * Autor: Santiago Gonzaga
  *
- * Definições para geração de código assembly x86-64 AT&T
+ * Definições para geração de código assembly
+ * (ARM64 macOS e x86-64 Linux System V, sintaxe AT&T)
  */
 
 #ifndef ASM_HPP
@@ -11,9 +12,36 @@
 #include "tac.hpp"
 #include "symbols.hpp"
 #include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+class ThreadPool;
+
+// Arquiteturas alvo suportadas
+#define ASM_TARGET_ARM64  1   // ARM64 Mach-O (Apple Silicon / macOS)
+#define ASM_TARGET_X86_64 2   // x86-64 ELF (Linux / System V AMD64 ABI)
 
 // Função principal para gerar código assembly
-// Recebe a lista de TACs (invertida) e o arquivo de saída
-void generateAsm(TAC* tacList, FILE* output);
+// Recebe a lista de TACs (invertida), o arquivo de saída, a arquitetura alvo,
+// o pool de threads que alocam registradores e geram as funções em
+// paralelo (a saída é a mesma para qualquer número de threads) e o modo
+// enxuto, que omite os comentários (descrição de cada TAC)
+void generateAsm(TAC* tacList, FILE* output, int target, ThreadPool& pool,
+                 bool lean = false);
+
+// Geração em fluxo, uma declaração global por vez (compilação com --stream):
+// generateAsmBegin emite o cabeçalho e fixa o modo enxuto; generateAsmGlobal a variável ou vetor
+// global, já com os valores iniciais em .data; generateAsmFunction uma
+// função (de TAC_BEGINFUN a TAC_ENDFUN, em ordem de execução), em que só
+// os temporários e os símbolos de ownSymbols (parâmetros e variáveis locais
+// declarados por ela) podem ir para registradores ou para o frame; e
+// generateAsmEnd encerra o arquivo
+void generateAsmBegin(FILE* output, int target = ASM_TARGET_ARM64, bool lean = false);
+void generateAsmGlobal(SymbolNode* sym, const std::vector<SymbolNode*>& initialValues,
+                       FILE* output, int target = ASM_TARGET_ARM64);
+void generateAsmFunction(const std::vector<TAC*>& funcTacs,
+                         const std::unordered_set<SymbolNode*>& ownSymbols,
+                         FILE* output, int target = ASM_TARGET_ARM64);
+void generateAsmEnd(FILE* output, int target = ASM_TARGET_ARM64);
 
 #endif // ASM_HPP
@@ -7,12 +7,72 @@
 
 #include "ast.hpp"
 #include <iostream>
+#include <new>
+#include <utility>
 #include <vector>
 
+// Arena global de nodos da AST
+ASTArena astArena;
+
+ASTArena::ASTArena() : used(BLOCK_NODES), total(0), itemsUsed(BLOCK_ITEMS) {}
+
+ASTArena::~ASTArena() { release(); }
+
+ASTNode *ASTArena::allocate() {
+  // Bloco atual cheio: alocar um novo (memória não inicializada)
+  if (used == BLOCK_NODES) {
+    blocks.push_back(static_cast<ASTNode *>(
+        ::operator new(BLOCK_NODES * sizeof(ASTNode))));
+    used = 0;
+  }
+
+  ASTNode *node = new (blocks.back() + used) ASTNode();
+  used++;
+  total++;
+  return node;
+}
+
+ASTNode **ASTArena::allocateItems(size_t count) {
+  // Vetores maiores que um bloco recebem um bloco próprio; o bloco atual é
+  // dado como cheio
+  if (count > BLOCK_ITEMS) {
+    itemBlocks.push_back(
+        static_cast<ASTNode **>(::operator new(count * sizeof(ASTNode *))));
+    itemsUsed = BLOCK_ITEMS;
+    return itemBlocks.back();
+  }
+
+  if (itemsUsed + count > BLOCK_ITEMS) {
+    itemBlocks.push_back(static_cast<ASTNode **>(
+        ::operator new(BLOCK_ITEMS * sizeof(ASTNode *))));
+    itemsUsed = 0;
+  }
+
+  ASTNode **items = itemBlocks.back() + itemsUsed;
+  itemsUsed += count;
+  return items;
+}
+
+void ASTArena::release() {
+  // ASTNode não possui destrutor não trivial: basta devolver os blocos
+  for (ASTNode *block : blocks) {
+    ::operator delete(block);
+  }
+  blocks.clear();
+  used = BLOCK_NODES;
+  total = 0;
+
+  for (ASTNode **block : itemBlocks) {
+    ::operator delete(block);
+  }
+  itemBlocks.clear();
+  itemsUsed = BLOCK_ITEMS;
+}
+
 // Função para criar um nodo da AST
 ASTNode *createNode(int type, SymbolNode *symbol, ASTNode *c0, ASTNode *c1,
                     ASTNode *c2, ASTNode *c3) {
-  ASTNode *node = new ASTNode();
+  ASTNode *node = astArena.allocate();
   node->type = type;
   node->symbol = symbol;
   node->child[0] = c0;
@@ -24,7 +84,7 @@ ASTNode *createNode(int type, SymbolNode *symbol, ASTNode *c0, ASTNode *c1,
 
 // Função para criar um nodo de operador
 ASTNode *createOperatorNode(int operator_type, ASTNode *c0, ASTNode *c1) {
-  ASTNode *node = new ASTNode();
+  ASTNode *node = astArena.allocate();
   node->type = AST_EXPRESSION_BINOP;
   node->operator_type = operator_type;
   node->child[0] = c0;
@@ -34,12 +94,67 @@ ASTNode *createOperatorNode(int operator_type, ASTNode *c0, ASTNode *c1) {
 
 // Função para criar um nodo folha
 ASTNode *createLeafNode(int type, SymbolNode *symbol) {
-  ASTNode *node = new ASTNode();
+  ASTNode *node = astArena.allocate();
   node->type = type;
   node->symbol = symbol;
   return node;
 }
 
+// Função para criar um nodo de lista vazio
+ASTNode *createListNode(int type) {
+  ASTNode *node = astArena.allocate();
+  node->type = type;
+  return node;
+}
+
+// Função para acrescentar um elemento ao fim de uma lista
+// O vetor de elementos dobra de tamanho quando enche; o vetor antigo fica na
+// arena, o que no pior caso dobra a memória usada pelos elementos
+ASTNode *appendToList(ASTNode *list, int type, ASTNode *item) {
+  if (!list) {
+    list = createListNode(type);
+  }
+  if (!item) {
+    return list;
+  }
+
+  if (list->itemCount == list->itemCapacity) {
+    int capacity = list->itemCapacity ? 2 * list->itemCapacity : 4;
+    ASTNode **items = astArena.allocateItems(capacity);
+    for (int i = 0; i < list->itemCount; i++) {
+      items[i] = list->items[i];
+    }
+    list->items = items;
+    list->itemCapacity = capacity;
+  }
+  list->items[list->itemCount++] = item;
+  return list;
+}
+
+// Função para copiar uma subárvore para outra arena
+ASTNode *cloneAST(ASTNode *node, ASTArena &arena) {
+  if (!node) {
+    return nullptr;
+  }
+
+  ASTNode *copy = arena.allocate();
+  *copy = *node;
+
+  if (isListNode(node->type)) {
+    // A cópia recebe um vetor exato (não será mais estendida)
+    copy->items = node->itemCount ? arena.allocateItems(node->itemCount) : nullptr;
+    copy->itemCapacity = node->itemCount;
+    for (int i = 0; i < node->itemCount; i++) {
+      copy->items[i] = cloneAST(node->items[i], arena);
+    }
+  } else {
+    for (int i = 0; i < 4; i++) {
+      copy->child[i] = cloneAST(node->child[i], arena);
+    }
+  }
+  return copy;
+}
+
 // Função para obter nome do tipo de nodo
 std::string getNodeTypeName(int type) {
   switch (type) {
@@ -136,31 +251,73 @@ std::string getOperatorName(int op) {
   }
 }
 
+// Verifica se o tipo de nodo é uma lista
+bool isListNode(int type) {
+  switch (type) {
+  case AST_DECLARATION_LIST:
+  case AST_PARAMETER_LIST:
+  case AST_COMMAND_LIST:
+  case AST_LITERAL_LIST:
+  case AST_ARGUMENT_LIST:
+  case AST_PRINT_LIST:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Coletar os elementos de uma lista na ordem do fonte
+void collectListItems(ASTNode *node, std::vector<ASTNode *> &items) {
+  if (!node)
+    return;
+
+  if (!isListNode(node->type)) {
+    items.push_back(node);
+    return;
+  }
+  items.insert(items.end(), node->items, node->items + node->itemCount);
+}
+
 // Função para imprimir um nodo da AST
+// Usa uma pilha explícita; os elementos de uma lista são impressos um nível
+// abaixo do nodo da lista
 void printNode(ASTNode *node, int level) {
   if (!node)
     return;
 
-  // Indentação baseada no nível
-  for (int i = 0; i < level; i++) {
-    std::cout << "  ";
-  }
+  std::vector<std::pair<ASTNode *, int>> stack(1, std::make_pair(node, level));
+  while (!stack.empty()) {
+    node = stack.back().first;
+    level = stack.back().second;
+    stack.pop_back();
 
-  // Imprime informações do nodo
-  std::cout << getNodeTypeName(node->type);
+    // Indentação baseada no nível
+    for (int i = 0; i < level; i++) {
+      std::cout << "  ";
+    }
 
-  if (node->type == AST_EXPRESSION_BINOP) {
-    std::cout << " (" << getOperatorName(node->operator_type) << ")";
-  } else if (node->symbol) {
-    std::cout << " (" << node->symbol->text << ")";
-  }
+    // Imprime informações do nodo
+    std::cout << getNodeTypeName(node->type);
+
+    if (node->type == AST_EXPRESSION_BINOP) {
+      std::cout << " (" << getOperatorName(node->operator_type) << ")";
+    } else if (node->symbol) {
+      std::cout << " (" << node->symbol->text << ")";
+    }
 
-  std::cout << std::endl;
+    std::cout << std::endl;
 
-  // Imprime filhos recursivamente
-  for (int i = 0; i < 4; i++) {
-    if (node->child[i]) {
-      printNode(node->child[i], level + 1);
+    // Empilha os filhos (ou os elementos da lista) em ordem inversa
+    if (isListNode(node->type)) {
+      for (int i = node->itemCount; i > 0; i--) {
+        stack.push_back(std::make_pair(node->items[i - 1], level + 1));
+      }
+    } else {
+      for (int i = 3; i >= 0; i--) {
+        if (node->child[i]) {
+          stack.push_back(std::make_pair(node->child[i], level + 1));
+        }
+      }
     }
   }
 }
@@ -177,6 +334,18 @@ void printAST(ASTNode *root) {
             << std::endl;
 }
 
+// Função auxiliar para gerar o código dos elementos de uma lista, com o
+// separador entre eles
+static void generateListCode(ASTNode *node, const char *separator,
+                             FILE *output) {
+  for (int i = 0; i < node->itemCount; i++) {
+    if (i > 0) {
+      fprintf(output, "%s", separator);
+    }
+    generateCode(node->items[i], output);
+  }
+}
+
 // Função para gerar código fonte a partir da AST
 void generateCode(ASTNode *node, FILE *output) {
   if (!node || !output)
@@ -190,12 +359,8 @@ void generateCode(ASTNode *node, FILE *output) {
     break;
 
   case AST_DECLARATION_LIST:
-    if (node->child[0]) {
-      generateCode(node->child[0], output);
-    }
-    if (node->child[1]) {
-      generateCode(node->child[1], output);
-    }
+  case AST_COMMAND_LIST:
+    generateListCode(node, "", output);
     break;
 
   case AST_VAR_DECLARATION:
@@ -245,13 +410,7 @@ void generateCode(ASTNode *node, FILE *output) {
     break;
 
   case AST_PARAMETER_LIST:
-    if (node->child[0]) {
-      generateCode(node->child[0], output);
-    }
-    if (node->child[1]) {
-      fprintf(output, ", ");
-      generateCode(node->child[1], output);
-    }
+    generateListCode(node, ", ", output);
     break;
 
   case AST_PARAMETER:
@@ -270,15 +429,6 @@ void generateCode(ASTNode *node, FILE *output) {
     fprintf(output, "}\n");
     break;
 
-  case AST_COMMAND_LIST:
-    if (node->child[0]) {
-      generateCode(node->child[0], output);
-    }
-    if (node->child[1]) {
-      generateCode(node->child[1], output);
-    }
-    break;
-
   case AST_ASSIGNMENT:
     if (node->child[0] && node->child[1]) {
       generateCode(node->child[0], output); // identifier
@@ -316,13 +466,7 @@ void generateCode(ASTNode *node, FILE *output) {
     break;
 
   case AST_PRINT_LIST:
-    if (node->child[0]) {
-      generateCode(node->child[0], output);
-    }
-    if (node->child[1]) {
-      fprintf(output, " ");
-      generateCode(node->child[1], output);
-    }
+    generateListCode(node, " ", output);
     break;
 
   case AST_RETURN:
@@ -406,23 +550,11 @@ void generateCode(ASTNode *node, FILE *output) {
     break;
 
   case AST_ARGUMENT_LIST:
-    if (node->child[0]) {
-      generateCode(node->child[0], output);
-    }
-    if (node->child[1]) {
-      fprintf(output, ", ");
-      generateCode(node->child[1], output);
-    }
+    generateListCode(node, ", ", output);
     break;
 
   case AST_LITERAL_LIST:
-    if (node->child[0]) {
-      generateCode(node->child[0], output);
-    }
-    if (node->child[1]) {
-      fprintf(output, " ");
-      generateCode(node->child[1], output);
-    }
+    generateListCode(node, " ", output);
     break;
 
   case AST_IDENTIFIER:
@@ -448,136 +580,242 @@ void generateCode(ASTNode *node, FILE *output) {
 }
 
 // Função para liberar memória da AST
-void freeAST(ASTNode *node) {
-  if (!node)
-    return;
-
-  for (int i = 0; i < 4; i++) {
-    if (node->child[i]) {
-      freeAST(node->child[i]);
-    }
-  }
-
-  delete node;
+void freeAST() {
+  astArena.release();
 }
 
 // ==================== GERAÇÃO DE CÓDIGO TAC ====================
 
 #include "tac.hpp"
+#include "threadpool.hpp"
 
 // Funções auxiliares para geração de TAC
 
-// Gerar código para operadores binários
-TAC* generateBinOp(ASTNode* node) {
-  if (!node) return nullptr;
+// Operações cujo resultado é booleano
+static bool isBooleanOperation(int tacType) {
+  switch (tacType) {
+    case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+    case TAC_AND: case TAC_OR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Mapear tipo de operador AST para tipo TAC
+static int binaryTacType(int operatorType) {
+  switch(operatorType) {
+    case AST_ADD: return TAC_ADD;
+    case AST_SUB: return TAC_SUB;
+    case AST_MUL: return TAC_MUL;
+    case AST_DIV: return TAC_DIV;
+    case AST_MOD: return TAC_MOD;
+    case AST_LT:  return TAC_LT;
+    case AST_GT:  return TAC_GT;
+    case AST_LE:  return TAC_LE;
+    case AST_GE:  return TAC_GE;
+    case AST_EQ:  return TAC_EQ;
+    case AST_DIF: return TAC_DIF;
+    case AST_AND: return TAC_AND;
+    case AST_OR:  return TAC_OR;
+    default:      return TAC_MOVE;
+  }
+}
 
-  TAC* code0 = generateTAC(node->child[0]);
-  TAC* code1 = generateTAC(node->child[1]);
+// Gerar código para operadores binários
+// Constantes são dobradas e identidades simplificadas durante a geração: o
+// resultado vira um TAC_SYMBOL com o literal (ou operando) equivalente
+TACCode generateBinOp(ASTNode* node) {
+  if (!node) return TACCode();
+
+  TACCode code0 = generateTAC(node->child[0]);
+  TACCode code1 = generateTAC(node->child[1]);
+
+  int tacType = binaryTacType(node->operator_type);
+
+  SymbolNode* left = code0.res();
+  SymbolNode* right = code1.res();
+  TACCode operands = tacJoin(code0, code1);
+
+  if (tacType != TAC_MOVE && left && right) {
+    int value;
+    if (isConstant(left) && isConstant(right) &&
+        tacFoldBinary(tacType, constantValue(left), constantValue(right), value)) {
+      SymbolNode* folded = isBooleanOperation(tacType) ? makeBoolConstant(value != 0)
+                                                       : makeIntConstant(value);
+      return tacJoin(operands, tacCreate(TAC_SYMBOL, folded, nullptr, nullptr));
+    }
 
-  // Mapear tipo de operador AST para tipo TAC
-  int tacType;
-  switch(node->operator_type) {
-    case AST_ADD: tacType = TAC_ADD; break;
-    case AST_SUB: tacType = TAC_SUB; break;
-    case AST_MUL: tacType = TAC_MUL; break;
-    case AST_DIV: tacType = TAC_DIV; break;
-    case AST_MOD: tacType = TAC_MOD; break;
-    case AST_LT:  tacType = TAC_LT;  break;
-    case AST_GT:  tacType = TAC_GT;  break;
-    case AST_LE:  tacType = TAC_LE;  break;
-    case AST_GE:  tacType = TAC_GE;  break;
-    case AST_EQ:  tacType = TAC_EQ;  break;
-    case AST_DIF: tacType = TAC_DIF; break;
-    case AST_AND: tacType = TAC_AND; break;
-    case AST_OR:  tacType = TAC_OR;  break;
-    default:      tacType = TAC_MOVE; break;
+    SymbolNode* simplified = tacSimplifyBinary(tacType, left, right);
+    if (simplified) {
+      return tacJoin(operands, tacCreate(TAC_SYMBOL, simplified, nullptr, nullptr));
+    }
   }
 
-  SymbolNode* result = makeTemp();
-  TAC* newTac = tacCreate(tacType, result,
-                          code0 ? code0->res : nullptr,
-                          code1 ? code1->res : nullptr);
+  SymbolNode* result = makeTemp(node->dataType);
+  TAC* newTac = tacCreate(tacType, result, left, right);
 
-  return tacJoin(tacJoin(code0, code1), newTac);
+  return tacJoin(operands, newTac);
 }
 
-// Gerar código para operadores unários
-TAC* generateUnOp(ASTNode* node) {
-  if (!node) return nullptr;
+// Gerar código para operadores unários (dobrando operandos constantes)
+TACCode generateUnOp(ASTNode* node) {
+  if (!node) return TACCode();
 
-  TAC* code0 = generateTAC(node->child[0]);
+  TACCode code0 = generateTAC(node->child[0]);
 
   int tacType = (node->operator_type == AST_NOT) ? TAC_NOT : TAC_NEG;
-  SymbolNode* result = makeTemp();
-  TAC* newTac = tacCreate(tacType, result, code0 ? code0->res : nullptr, nullptr);
+
+  SymbolNode* operand = code0.res();
+  if (isConstant(operand)) {
+    int value = constantValue(operand);
+    SymbolNode* folded = (tacType == TAC_NOT) ? makeBoolConstant(value == 0)
+                                              : makeIntConstant((int)(0u - (unsigned)value));
+    return tacJoin(code0, tacCreate(TAC_SYMBOL, folded, nullptr, nullptr));
+  }
+
+  SymbolNode* result = makeTemp(node->dataType);
+  TAC* newTac = tacCreate(tacType, result, operand, nullptr);
 
   return tacJoin(code0, newTac);
 }
 
-// Gerar código para IF
-TAC* generateIf(ASTNode* node) {
-  if (!node) return nullptr;
+// Desvio para uma condição de valor conhecido: incondicional ou nenhum código
+static TACCode constantBranch(bool value, SymbolNode* label, bool jumpIfTrue) {
+  if (value != jumpIfTrue) return TACCode();
+  return tacCreate(TAC_JUMP, label, nullptr, nullptr);
+}
+
+// Desvio condicional com avaliação em curto-circuito: desvia para o label
+// quando o valor da condição é jumpIfTrue e segue adiante caso contrário
+// & e | desviam assim que o resultado é conhecido, sem avaliar o operando
+// da direita; ~ apenas inverte o sentido do desvio
+// Comparações viram um único desvio com comparação (TAC_JLT, ...), sem
+// materializar o booleano em um temporário
+// Condições constantes viram um desvio incondicional ou nenhum código
+static TACCode generateBranch(ASTNode* condition, SymbolNode* label, bool jumpIfTrue) {
+  if (!condition) return TACCode();
+
+  if (condition->type == AST_EXPRESSION_BINOP &&
+      (condition->operator_type == AST_AND || condition->operator_type == AST_OR)) {
+    bool isAnd = (condition->operator_type == AST_AND);
+
+    // a & b é falso se qualquer um for falso; a | b é verdadeiro se
+    // qualquer um for verdadeiro: os dois operandos desviam para o label
+    if (isAnd != jumpIfTrue) {
+      TACCode left = generateBranch(condition->child[0], label, jumpIfTrue);
+      TACCode right = generateBranch(condition->child[1], label, jumpIfTrue);
+      return tacJoin(left, right);
+    }
+
+    // Caso contrário o operando da esquerda pode decidir sozinho o sentido
+    // oposto, saltando o teste do operando da direita
+    SymbolNode* labelSkip = makeLabel();
+    TACCode left = generateBranch(condition->child[0], labelSkip, !jumpIfTrue);
+    TACCode right = generateBranch(condition->child[1], label, jumpIfTrue);
+    TAC* tacLabelSkip = tacCreate(TAC_LABEL, labelSkip, nullptr, nullptr);
+    return tacJoin(tacJoin(left, right), tacLabelSkip);
+  }
+
+  if (condition->type == AST_EXPRESSION_UNOP && condition->operator_type == AST_NOT) {
+    return generateBranch(condition->child[0], label, !jumpIfTrue);
+  }
+
+  if (condition->type == AST_EXPRESSION_BINOP) {
+    int tacType = binaryTacType(condition->operator_type);
+    int jumpType = tacCompareJump(tacType, !jumpIfTrue);
+
+    if (jumpType != 0) {
+      TACCode code0 = generateTAC(condition->child[0]);
+      TACCode code1 = generateTAC(condition->child[1]);
+      SymbolNode* left = code0.res();
+      SymbolNode* right = code1.res();
+      TACCode operands = tacJoin(code0, code1);
+
+      // Comparação com resultado conhecido em tempo de compilação
+      int value;
+      if (isConstant(left) && isConstant(right) &&
+          tacFoldBinary(tacType, constantValue(left), constantValue(right), value)) {
+        return tacJoin(operands, constantBranch(value != 0, label, jumpIfTrue));
+      }
+      SymbolNode* simplified = tacSimplifyBinary(tacType, left, right);
+      if (isConstant(simplified)) {
+        return tacJoin(operands, constantBranch(constantValue(simplified) != 0, label, jumpIfTrue));
+      }
+
+      return tacJoin(operands, tacCreate(jumpType, label, left, right));
+    }
+  }
+
+  TACCode code = generateTAC(condition);
+  SymbolNode* value = code.res();
+
+  if (isConstant(value)) {
+    return tacJoin(code, constantBranch(constantValue(value) != 0, label, jumpIfTrue));
+  }
+
+  return tacJoin(code, tacCreate(jumpIfTrue ? TAC_IFNZ : TAC_IFZ, label, value, nullptr));
+}
 
-  TAC* codeCondition = generateTAC(node->child[0]);  // Condição
-  TAC* codeThen = generateTAC(node->child[1]);       // Bloco then
+// Gerar código para IF
+TACCode generateIf(ASTNode* node) {
+  if (!node) return TACCode();
 
   SymbolNode* labelElse = makeLabel();
-  TAC* tacIfz = tacCreate(TAC_IFZ, labelElse,
-                          codeCondition ? codeCondition->res : nullptr, nullptr);
+
+  TACCode codeCondition = generateBranch(node->child[0], labelElse, false);  // Condição
+  TACCode codeThen = generateTAC(node->child[1]);                            // Bloco then
+
   TAC* tacLabel = tacCreate(TAC_LABEL, labelElse, nullptr, nullptr);
 
-  // Juntar: condição -> ifz -> then -> label
-  return tacJoin(tacJoin(tacJoin(codeCondition, tacIfz), codeThen), tacLabel);
+  // Juntar: condição (desvia se falsa) -> then -> label
+  return tacJoin(tacJoin(codeCondition, codeThen), tacLabel);
 }
 
 // Gerar código para IF-ELSE
-TAC* generateIfElse(ASTNode* node) {
-  if (!node) return nullptr;
-
-  TAC* codeCondition = generateTAC(node->child[0]);  // Condição
-  TAC* codeThen = generateTAC(node->child[1]);       // Bloco then
-  TAC* codeElse = generateTAC(node->child[2]);       // Bloco else
+TACCode generateIfElse(ASTNode* node) {
+  if (!node) return TACCode();
 
   SymbolNode* labelElse = makeLabel();
   SymbolNode* labelEnd = makeLabel();
 
-  TAC* tacIfz = tacCreate(TAC_IFZ, labelElse,
-                          codeCondition ? codeCondition->res : nullptr, nullptr);
+  TACCode codeCondition = generateBranch(node->child[0], labelElse, false);  // Condição
+  TACCode codeThen = generateTAC(node->child[1]);                            // Bloco then
+  TACCode codeElse = generateTAC(node->child[2]);                            // Bloco else
+
   TAC* tacJumpEnd = tacCreate(TAC_JUMP, labelEnd, nullptr, nullptr);
   TAC* tacLabelElse = tacCreate(TAC_LABEL, labelElse, nullptr, nullptr);
   TAC* tacLabelEnd = tacCreate(TAC_LABEL, labelEnd, nullptr, nullptr);
 
-  // Juntar: condição -> ifz -> then -> jump -> labelElse -> else -> labelEnd
-  return tacJoin(tacJoin(tacJoin(tacJoin(tacJoin(tacJoin(
-         codeCondition, tacIfz), codeThen), tacJumpEnd),
+  // Juntar: condição (desvia se falsa) -> then -> jump -> labelElse -> else -> labelEnd
+  return tacJoin(tacJoin(tacJoin(tacJoin(tacJoin(
+         codeCondition, codeThen), tacJumpEnd),
          tacLabelElse), codeElse), tacLabelEnd);
 }
 
 // Gerar código para WHILE
-TAC* generateWhile(ASTNode* node) {
-  if (!node) return nullptr;
-
-  TAC* codeCondition = generateTAC(node->child[0]);  // Condição
-  TAC* codeBody = generateTAC(node->child[1]);       // Corpo do loop
+TACCode generateWhile(ASTNode* node) {
+  if (!node) return TACCode();
 
   SymbolNode* labelLoop = makeLabel();
   SymbolNode* labelEnd = makeLabel();
 
+  TACCode codeCondition = generateBranch(node->child[0], labelEnd, false);  // Condição
+  TACCode codeBody = generateTAC(node->child[1]);                           // Corpo do loop
+
   TAC* tacLabelLoop = tacCreate(TAC_LABEL, labelLoop, nullptr, nullptr);
-  TAC* tacIfz = tacCreate(TAC_IFZ, labelEnd,
-                          codeCondition ? codeCondition->res : nullptr, nullptr);
   TAC* tacJumpLoop = tacCreate(TAC_JUMP, labelLoop, nullptr, nullptr);
   TAC* tacLabelEnd = tacCreate(TAC_LABEL, labelEnd, nullptr, nullptr);
 
-  // Juntar: labelLoop -> condição -> ifz -> body -> jump -> labelEnd
-  return tacJoin(tacJoin(tacJoin(tacJoin(tacJoin(
-         tacLabelLoop, codeCondition), tacIfz), codeBody),
+  // Juntar: labelLoop -> condição (desvia se falsa) -> body -> jump -> labelEnd
+  return tacJoin(tacJoin(tacJoin(tacJoin(
+         tacLabelLoop, codeCondition), codeBody),
          tacJumpLoop), tacLabelEnd);
 }
 
 // Gerar código para função
-TAC* generateFunction(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateFunction(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Estrutura da função:
   // child[0] = tipo de retorno (não gera código)
@@ -586,10 +824,13 @@ TAC* generateFunction(ASTNode* node) {
   // child[3] = DECLARATION_LIST (variáveis locais e bloco)
 
   SymbolNode* funcSymbol = node->child[1] ? node->child[1]->symbol : nullptr;
-  if (!funcSymbol) return nullptr;
+  if (!funcSymbol) return TACCode();
 
-  TAC* codeParams = generateTAC(node->child[2]);  // Parâmetros
-  TAC* codeBody = generateTAC(node->child[3]);    // Declarações locais e corpo
+  // Temporários e labels numerados por função (nomes qualificados por ela)
+  beginFunctionSymbols(funcSymbol);
+
+  TACCode codeParams = generateTAC(node->child[2]);  // Parâmetros
+  TACCode codeBody = generateTAC(node->child[3]);    // Declarações locais e corpo
 
   TAC* tacBegin = tacCreate(TAC_BEGINFUN, funcSymbol, nullptr, nullptr);
   TAC* tacEnd = tacCreate(TAC_ENDFUN, funcSymbol, nullptr, nullptr);
@@ -598,130 +839,125 @@ TAC* generateFunction(ASTNode* node) {
   return tacJoin(tacJoin(tacJoin(tacBegin, codeParams), codeBody), tacEnd);
 }
 
-// Função auxiliar para coletar todos os argumentos de uma ARGUMENT_LIST recursivamente
+// Função auxiliar para coletar todos os argumentos de uma ARGUMENT_LIST
 void collectArguments(ASTNode* node, std::vector<ASTNode*>& args) {
-  if (!node) return;
+  collectListItems(node, args);
+}
 
-  if (node->type == AST_ARGUMENT_LIST) {
-    // child[0] = expressão do argumento atual
-    // child[1] = próximo elemento da lista (outro ARGUMENT_LIST ou nullptr)
-    if (node->child[0]) {
-      args.push_back(node->child[0]);
+// Função auxiliar para coletar os parâmetros de uma função na ordem de declaração
+void collectParameters(ASTNode* node, std::vector<SymbolNode*>& params) {
+  std::vector<ASTNode*> items;
+  collectListItems(node, items);
+  for (ASTNode* item : items) {
+    if (item->type == AST_PARAMETER && item->child[1] && item->child[1]->symbol) {
+      params.push_back(item->child[1]->symbol);
     }
-    collectArguments(node->child[1], args);
-  } else {
-    // É uma expressão direta (único argumento sem lista)
-    args.push_back(node);
   }
 }
 
 // Gerar código para chamada de função
-TAC* generateFunctionCall(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateFunctionCall(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Estrutura: child[0] = IDENTIFIER, child[1] = argument_list
   SymbolNode* funcSymbol = node->child[0] ? node->child[0]->symbol : nullptr;
-  if (!funcSymbol) return nullptr;
+  if (!funcSymbol) return TACCode();
 
   // Coletar todos os argumentos
   std::vector<ASTNode*> args;
   collectArguments(node->child[1], args);
 
   // Gerar código para cada argumento
-  TAC* argTacs = nullptr;
+  TACCode argTacs;
   for (ASTNode* arg : args) {
-    TAC* argCode = generateTAC(arg);
-    if (argCode) {
-      TAC* argTac = tacCreate(TAC_ARG, argCode->res, nullptr, nullptr);
+    TACCode argCode = generateTAC(arg);
+    if (!argCode.empty()) {
+      TAC* argTac = tacCreate(TAC_ARG, argCode.res(), nullptr, nullptr);
       argTacs = tacJoin(tacJoin(argTacs, argCode), argTac);
     }
   }
 
-  SymbolNode* result = makeTemp();
+  SymbolNode* result = makeTemp(node->dataType);
   TAC* tacCall = tacCreate(TAC_CALL, result, funcSymbol, nullptr);
 
   return tacJoin(argTacs, tacCall);
 }
 
 // Gerar código para atribuição
-TAC* generateAssignment(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateAssignment(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Estrutura: child[0] = IDENTIFIER, child[1] = expression
   SymbolNode* target = node->child[0] ? node->child[0]->symbol : nullptr;
-  if (!target) return nullptr;
+  if (!target) return TACCode();
 
-  TAC* codeExpr = generateTAC(node->child[1]);  // Expressão do lado direito
+  TACCode codeExpr = generateTAC(node->child[1]);  // Expressão do lado direito
 
   TAC* tacMove = tacCreate(TAC_MOVE, target,
-                           codeExpr ? codeExpr->res : nullptr, nullptr);
+                           codeExpr.res(), nullptr);
 
   return tacJoin(codeExpr, tacMove);
 }
 
 // Gerar código para atribuição em vetor
-TAC* generateVectorAssignment(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateVectorAssignment(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Estrutura: child[0] = IDENTIFIER, child[1] = index_expression, child[2] = value_expression
   SymbolNode* vecSymbol = node->child[0] ? node->child[0]->symbol : nullptr;
-  if (!vecSymbol) return nullptr;
+  if (!vecSymbol) return TACCode();
 
-  TAC* codeIndex = generateTAC(node->child[1]);  // Índice
-  TAC* codeExpr = generateTAC(node->child[2]);   // Expressão
+  TACCode codeIndex = generateTAC(node->child[1]);  // Índice
+  TACCode codeExpr = generateTAC(node->child[2]);   // Expressão
 
   TAC* tacVecWrite = tacCreate(TAC_VEC_WRITE, vecSymbol,
-                               codeIndex ? codeIndex->res : nullptr,
-                               codeExpr ? codeExpr->res : nullptr);
+                               codeIndex.res(),
+                               codeExpr.res());
 
   return tacJoin(tacJoin(codeIndex, codeExpr), tacVecWrite);
 }
 
 // Gerar código para acesso a vetor
-TAC* generateVectorAccess(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateVectorAccess(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Estrutura: child[0] = IDENTIFIER, child[1] = index_expression
   SymbolNode* vecSymbol = node->child[0] ? node->child[0]->symbol : nullptr;
-  if (!vecSymbol) return nullptr;
+  if (!vecSymbol) return TACCode();
 
-  TAC* codeIndex = generateTAC(node->child[1]);  // Índice
+  TACCode codeIndex = generateTAC(node->child[1]);  // Índice
 
-  SymbolNode* result = makeTemp();
+  SymbolNode* result = makeTemp(node->dataType);
   TAC* tacVecAccess = tacCreate(TAC_VEC_ACCESS, result, vecSymbol,
-                                codeIndex ? codeIndex->res : nullptr);
+                                codeIndex.res());
 
   return tacJoin(codeIndex, tacVecAccess);
 }
 
-// Função auxiliar para coletar todos os itens de uma PRINT_LIST recursivamente
+// Função auxiliar para coletar todos os itens de uma PRINT_LIST na ordem do fonte
 void collectPrintItems(ASTNode* node, std::vector<ASTNode*>& items) {
-  if (!node) return;
+  collectListItems(node, items);
+}
 
-  if (node->type == AST_PRINT_LIST) {
-    // Processar recursivamente: primeiro child[0], depois child[1]
-    collectPrintItems(node->child[0], items);
-    collectPrintItems(node->child[1], items);
-  } else {
-    // É um item a ser impresso (não é uma lista)
-    items.push_back(node);
-  }
+// Função auxiliar para coletar os literais de uma LITERAL_LIST na ordem do fonte
+void collectLiterals(ASTNode* node, std::vector<ASTNode*>& literals) {
+  collectListItems(node, literals);
 }
 
 // Gerar código para PRINT
-TAC* generatePrint(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generatePrint(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Coletar todos os itens a serem impressos
   std::vector<ASTNode*> items;
   collectPrintItems(node->child[0], items);
 
   // Gerar código para cada item
-  TAC* result = nullptr;
+  TACCode result;
   for (ASTNode* item : items) {
-    TAC* codeExpr = generateTAC(item);
-    if (codeExpr) {
-      TAC* tacPrint = tacCreate(TAC_PRINT, nullptr, codeExpr->res, nullptr);
+    TACCode codeExpr = generateTAC(item);
+    if (!codeExpr.empty()) {
+      TAC* tacPrint = tacCreate(TAC_PRINT, nullptr, codeExpr.res(), nullptr);
       result = tacJoin(tacJoin(result, codeExpr), tacPrint);
     }
   }
@@ -730,38 +966,38 @@ TAC* generatePrint(ASTNode* node) {
 }
 
 // Gerar código para READ
-TAC* generateRead(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateRead(ASTNode* node) {
+  if (!node) return TACCode();
 
   // Estrutura: child[0] = IDENTIFIER
   SymbolNode* target = node->child[0] ? node->child[0]->symbol : nullptr;
-  if (!target) return nullptr;
+  if (!target) return TACCode();
 
   TAC* tacRead = tacCreate(TAC_READ, target, nullptr, nullptr);
   return tacRead;
 }
 
 // Gerar código para RETURN
-TAC* generateReturn(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateReturn(ASTNode* node) {
+  if (!node) return TACCode();
 
-  TAC* codeExpr = generateTAC(node->child[0]);  // Expressão de retorno
+  TACCode codeExpr = generateTAC(node->child[0]);  // Expressão de retorno
 
   TAC* tacRet = tacCreate(TAC_RET, nullptr,
-                          codeExpr ? codeExpr->res : nullptr, nullptr);
+                          codeExpr.res(), nullptr);
 
   return tacJoin(codeExpr, tacRet);
 }
 
 // Função principal de geração de código TAC
-TAC* generateTAC(ASTNode* node) {
-  if (!node) return nullptr;
+TACCode generateTAC(ASTNode* node) {
+  if (!node) return TACCode();
 
-  TAC* code0 = nullptr;
-  TAC* code1 = nullptr;
-  TAC* code2 = nullptr;
-  TAC* code3 = nullptr;
-  TAC* result = nullptr;
+  TACCode code0;
+  TACCode code1;
+  TACCode code2;
+  TACCode code3;
+  TACCode result;
 
   switch(node->type) {
     case AST_IDENTIFIER:
@@ -822,14 +1058,20 @@ TAC* generateTAC(ASTNode* node) {
       result = generateFunction(node);
       break;
 
-    case AST_PROGRAM:
     case AST_DECLARATION_LIST:
     case AST_COMMAND_LIST:
-    case AST_BLOCK:
     case AST_PARAMETER_LIST:
     case AST_ARGUMENT_LIST:
     case AST_PRINT_LIST:
     case AST_LITERAL_LIST:
+      // Listas: processar os elementos em sequência
+      for (int i = 0; i < node->itemCount; i++) {
+        result = tacJoin(result, generateTAC(node->items[i]));
+      }
+      break;
+
+    case AST_PROGRAM:
+    case AST_BLOCK:
       // Processar filhos sequencialmente
       code0 = generateTAC(node->child[0]);
       code1 = generateTAC(node->child[1]);
@@ -843,24 +1085,66 @@ TAC* generateTAC(ASTNode* node) {
       // child[0] = tipo, child[1] = identificador, child[2] = valor inicial
       if (node->child[1] && node->child[2]) {
         SymbolNode* varSym = node->child[1]->symbol;
-        TAC* initVal = generateTAC(node->child[2]);
-        if (varSym && initVal) {
-          TAC* tacInit = tacCreate(TAC_MOVE, varSym, initVal->res, nullptr);
+        TACCode initVal = generateTAC(node->child[2]);
+        if (varSym && !initVal.empty()) {
+          TAC* tacInit = tacCreate(TAC_MOVE, varSym, initVal.res(), nullptr);
           result = tacJoin(initVal, tacInit);
         }
       }
       break;
 
     case AST_VECTOR_DECLARATION:
+      // Gerar TAC_VEC_WRITE para cada literal da inicialização do vetor
+      // child[1] = identificador, child[3] = lista de literais (opcional)
+      if (node->child[1] && node->child[1]->symbol && node->child[3]) {
+        std::vector<ASTNode*> literals;
+        collectLiterals(node->child[3], literals);
+        for (size_t i = 0; i < literals.size(); i++) {
+          SymbolNode* index = makeIntConstant((int)i);
+          TAC* tacWrite = tacCreate(TAC_VEC_WRITE, node->child[1]->symbol,
+                                    index, literals[i]->symbol);
+          result = tacJoin(result, tacWrite);
+        }
+      }
+      break;
+
     case AST_PARAMETER:
-      // Declarações de vetor e parâmetros não geram código TAC diretamente
-      result = nullptr;
+      // Parâmetros não geram código TAC diretamente
+      result = TACCode();
       break;
 
     default:
-      result = nullptr;
+      result = TACCode();
       break;
   }
 
   return result;
-}
\ No newline at end of file
+}
+
+// Gerar código do programa: declarações globais na thread atual, funções
+// em paralelo (cada uma só cria os próprios temporários e labels)
+TACCode generateProgramTAC(ASTNode* root, ThreadPool& pool) {
+  if (!root || root->type != AST_PROGRAM) return generateTAC(root);
+
+  std::vector<ASTNode*> declarations;
+  collectListItems(root->child[0], declarations);
+
+  std::vector<TACCode> codes(declarations.size());
+  std::vector<size_t> functions;
+  for (size_t i = 0; i < declarations.size(); i++) {
+    if (declarations[i]->type == AST_FUNCTION_DECLARATION) {
+      functions.push_back(i);
+    } else {
+      codes[i] = generateTAC(declarations[i]);
+    }
+  }
+  pool.parallelFor(functions.size(), [&](size_t f) {
+    codes[functions[f]] = generateTAC(declarations[functions[f]]);
+  });
+
+  TACCode result;
+  for (const TACCode& code : codes) {
+    result = tacJoin(result, code);
+  }
+  return result;
+}
@@ -10,6 +10,7 @@
 
 #include "symbols.hpp"
 #include <string>
+#include <vector>
 
 // Tipos de nodos da AST
 #define AST_PROGRAM 1
@@ -56,24 +57,82 @@
 #define AST_NOT 113
 
 // Estrutura do nodo da AST
+// Nodos de lista (ver isListNode) não usam child: guardam os elementos,
+// na ordem do fonte, no vetor contíguo items (alocado na arena)
 struct ASTNode {
     int type;                 // Tipo do nodo
     SymbolNode* symbol;       // Ponteiro para a tabela de símbolos (para folhas)
     int operator_type;        // Tipo do operador (para expressões)
+    int dataType;             // Tipo de dado da expressão (anotado na análise semântica)
     struct ASTNode* child[4]; // Ponteiros para filhos (máximo 4)
+    struct ASTNode** items;   // Elementos de um nodo de lista
+    int itemCount;            // Número de elementos da lista
+    int itemCapacity;         // Capacidade de items
 
-    ASTNode() : type(0), symbol(nullptr), operator_type(0) {
+    ASTNode() : type(0), symbol(nullptr), operator_type(0), dataType(0),
+                items(nullptr), itemCount(0), itemCapacity(0) {
         for (int i = 0; i < 4; i++) {
             child[i] = nullptr;
         }
     }
 };
 
+// Arena de nodos da AST: os nodos são alocados sequencialmente em blocos
+// contíguos e liberados todos de uma vez, sem percorrer a árvore
+class ASTArena {
+private:
+    static const size_t BLOCK_NODES = 4096; // Nodos por bloco
+    static const size_t BLOCK_ITEMS = 8192; // Ponteiros por bloco de elementos
+
+    std::vector<ASTNode*> blocks;   // Blocos alocados
+    size_t used;                    // Nodos usados no último bloco
+    size_t total;                   // Total de nodos alocados
+
+    std::vector<ASTNode**> itemBlocks;  // Blocos de elementos de listas
+    size_t itemsUsed;                   // Ponteiros usados no último bloco
+
+public:
+    ASTArena();
+    ~ASTArena();
+
+    // Aloca um nodo inicializado (construtor padrão de ASTNode)
+    ASTNode* allocate();
+
+    // Aloca um vetor (não inicializado) de count ponteiros para elementos
+    ASTNode** allocateItems(size_t count);
+
+    // Libera todos os nodos de uma vez
+    void release();
+
+    // Número de nodos alocados desde o último release
+    size_t size() const { return total; }
+};
+
+// Arena global usada pelas funções de criação de nodos (e, portanto,
+// pelas ações do parser)
+extern ASTArena astArena;
+
 // Funções para manipulação da AST
 ASTNode* createNode(int type, SymbolNode* symbol, ASTNode* c0, ASTNode* c1, ASTNode* c2, ASTNode* c3);
 ASTNode* createOperatorNode(int operator_type, ASTNode* c0, ASTNode* c1);
 ASTNode* createLeafNode(int type, SymbolNode* symbol);
 
+// Funções para listas: appendToList acrescenta item (se não nulo) ao fim de
+// list, criando um nodo de lista do tipo type se list for nulo
+ASTNode* createListNode(int type);
+ASTNode* appendToList(ASTNode* list, int type, ASTNode* item);
+
+// Copia a subárvore de node para a arena indicada (os símbolos são
+// compartilhados), para que sobreviva à liberação de astArena
+ASTNode* cloneAST(ASTNode* node, ASTArena& arena);
+
+// Verifica se o tipo de nodo é uma lista (elementos em items)
+bool isListNode(int type);
+
+// Coletar os elementos de uma lista na ordem do fonte (um nodo que não é
+// lista é tratado como lista de um elemento)
+void collectListItems(ASTNode* node, std::vector<ASTNode*>& items);
+
 // Funções para impressão da AST
 void printNode(ASTNode* node, int level);
 void printAST(ASTNode* root);
@@ -81,8 +140,8 @@ void printAST(ASTNode* root);
 // Função para geração de código
 void generateCode(ASTNode* node, FILE* output);
 
-// Função para liberar memória da AST
-void freeAST(ASTNode* node);
+// Função para liberar memória da AST (todos os nodos da arena de uma vez)
+void freeAST();
 
 // Função auxiliar para obter nome do tipo de nodo
 std::string getNodeTypeName(int type);
@@ -90,10 +149,20 @@ std::string getNodeTypeName(int type);
 // Função auxiliar para obter nome do operador
 std::string getOperatorName(int op);
 
+// Coletar os símbolos dos parâmetros de uma PARAMETER_LIST, em ordem
+void collectParameters(ASTNode* node, std::vector<SymbolNode*>& params);
+
 // Forward declaration for TAC
 struct TAC;
+struct TACCode;
+class ThreadPool;
 
 // Função para gerar código TAC a partir da AST
-TAC* generateTAC(ASTNode* node);
+TACCode generateTAC(ASTNode* node);
+
+// Função para gerar o código TAC do programa inteiro: as funções são
+// traduzidas em paralelo no pool e juntadas na ordem do fonte (o resultado
+// não depende do número de threads)
+TACCode generateProgramTAC(ASTNode* root, ThreadPool& pool);
 
 #endif // AST_HPP
\ No newline at end of file
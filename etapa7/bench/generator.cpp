@@ -0,0 +1,336 @@
+/*
+ * Compiladores - etapa7 - bench/generator.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Gerador de programas sintéticos válidos na linguagem da etapa7, para medir
+ * a vazão do compilador em entradas grandes
+ *
+ * Os programas passam pelas análises sintática e semântica e terminam ao
+ * executar: laços contam até um limite fixo com contadores próprios,
+ * divisões e índices de vetor são sempre seguros e as funções "folha" (as
+ * primeiras) não fazem chamadas, enquanto as demais só chamam folhas
+ *
+ * Uso: generator [opcoes] > programa.txt
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Parâmetros do programa gerado
+struct GeneratorOptions {
+    int functions;      // Funções além do main
+    int statements;     // Comandos por função (contando os aninhados)
+    int depth;          // Profundidade máxima de aninhamento de if/while
+    int width;          // Operandos por expressão
+    int globals;        // Variáveis globais inteiras
+    int vectors;        // Vetores globais
+    int vectorSize;     // Elementos de cada vetor
+    int loopTrips;      // Iterações de cada while
+    unsigned seed;
+
+    GeneratorOptions()
+        : functions(10), statements(50), depth(3), width(4), globals(10),
+          vectors(2), vectorSize(16), loopTrips(2), seed(1) {}
+};
+
+// Informações da função sendo gerada
+struct FunctionInfo {
+    std::string name;
+    std::vector<std::string> params;
+    std::vector<std::string> locals;    // Variáveis inteiras atribuíveis
+    std::vector<std::string> counters;  // Contador de laço de cada nível
+    bool canCall;                       // Pode chamar funções folha
+};
+
+static GeneratorOptions options;
+static std::mt19937 rng;
+static std::vector<int> functionArity;  // Parâmetros de cada função
+static int leafFunctions = 0;           // Funções 0..leafFunctions-1 não chamam ninguém
+static std::string out;
+
+// Inteiro uniforme em [lo, hi]
+static int randomInt(int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+static bool chance(int percent) {
+    return randomInt(1, 100) <= percent;
+}
+
+static std::string globalName(int i) { return "g" + std::to_string(i); }
+static std::string vectorName(int i) { return "v" + std::to_string(i); }
+static std::string functionName(int i) { return "f" + std::to_string(i); }
+
+static void indent(int level) {
+    out.append(2 * level, ' ');
+}
+
+// Variável inteira legível na função
+static std::string randomVariable(const FunctionInfo& func) {
+    int total = (int)(func.params.size() + func.locals.size()) + options.globals;
+    int pick = randomInt(0, total - 1);
+    if (pick < (int)func.params.size()) return func.params[pick];
+    pick -= (int)func.params.size();
+    if (pick < (int)func.locals.size()) return func.locals[pick];
+    return globalName(pick - (int)func.locals.size());
+}
+
+// Variável inteira atribuível (parâmetros ficam de fora para preservar
+// os argumentos recebidos)
+static std::string randomTarget(const FunctionInfo& func) {
+    int total = (int)func.locals.size() + options.globals;
+    int pick = randomInt(0, total - 1);
+    if (pick < (int)func.locals.size()) return func.locals[pick];
+    return globalName(pick - (int)func.locals.size());
+}
+
+// Índice sempre dentro de [0, vectorSize)
+static std::string safeIndex(const std::string& expr) {
+    std::string size = std::to_string(options.vectorSize);
+    return "((" + expr + ") % " + size + " + " + size + ") % " + size;
+}
+
+static std::string randomOperand(const FunctionInfo& func, bool allowCall);
+
+// Expressão inteira com width operandos
+static std::string randomExpression(const FunctionInfo& func, int width, bool allowCall) {
+    std::string expr = randomOperand(func, allowCall);
+    for (int i = 1; i < width; i++) {
+        std::string operand = randomOperand(func, allowCall);
+        switch (randomInt(0, 5)) {
+        case 0:
+        case 1:
+            expr = expr + " + " + operand;
+            break;
+        case 2:
+            expr = expr + " - " + operand;
+            break;
+        case 3:
+            expr = "(" + expr + ") * " + operand;
+            break;
+        case 4:
+            // Divisor em [2, 14]: nunca zero
+            expr = "(" + expr + ") / (" + operand + " % 7 + 8)";
+            break;
+        default:
+            expr = "(" + expr + ") % (" + operand + " % 5 + 6)";
+            break;
+        }
+    }
+    return expr;
+}
+
+static std::string randomOperand(const FunctionInfo& func, bool allowCall) {
+    int kind = randomInt(0, 9);
+    if (kind <= 3) return randomVariable(func);
+    if (kind <= 5) return std::to_string(randomInt(0, 99));
+    if (kind <= 7 && options.vectors > 0) {
+        std::string index = chance(50) ? std::to_string(randomInt(0, options.vectorSize - 1))
+                                       : safeIndex(randomVariable(func));
+        return vectorName(randomInt(0, options.vectors - 1)) + "[" + index + "]";
+    }
+    if (allowCall && func.canCall) {
+        int callee = randomInt(0, leafFunctions - 1);
+        std::string call = functionName(callee) + "(";
+        for (int a = 0; a < functionArity[callee]; a++) {
+            if (a) call += ", ";
+            call += randomVariable(func);
+        }
+        return call + ")";
+    }
+    return randomVariable(func);
+}
+
+// Condição booleana com comparações ligadas por & e |
+static std::string randomCondition(const FunctionInfo& func) {
+    static const char* relational[] = {"<", ">", "<=", ">=", "==", "!="};
+    int terms = randomInt(1, 3);
+    std::string cond;
+    for (int i = 0; i < terms; i++) {
+        std::string term = randomExpression(func, randomInt(1, 2), false) + " " +
+                           relational[randomInt(0, 5)] + " " +
+                           randomExpression(func, randomInt(1, 2), false);
+        if (chance(15)) term = "~(" + term + ")";
+        if (i == 0) {
+            cond = term;
+        } else {
+            cond = "(" + cond + ")" + (chance(50) ? " & " : " | ") + "(" + term + ")";
+        }
+    }
+    return cond;
+}
+
+static void generateStatements(FunctionInfo& func, int& budget, int level, int nesting);
+
+// Gera um comando, consumindo budget; level é a indentação e nesting o
+// número de if/while que envolvem o comando
+static void generateStatement(FunctionInfo& func, int& budget, int level, int nesting) {
+    budget--;
+    int kind = randomInt(0, 99);
+    bool compound = nesting < options.depth && budget > 0;
+
+    if (compound && kind < 12) {
+        // Laço com contador próprio do nível
+        const std::string& counter = func.counters[nesting];
+        indent(level); out += counter + " = 0;\n";
+        indent(level); out += "while (" + counter + " < " + std::to_string(options.loopTrips) + ")\n";
+        indent(level); out += "{\n";
+        generateStatements(func, budget, level + 1, nesting + 1);
+        indent(level + 1); out += counter + " = " + counter + " + 1;\n";
+        indent(level); out += "}\n";
+    } else if (compound && kind < 24) {
+        indent(level); out += "if (" + randomCondition(func) + ")\n";
+        indent(level); out += "{\n";
+        generateStatements(func, budget, level + 1, nesting + 1);
+        indent(level); out += "}\n";
+        if (chance(50) && budget > 0) {
+            indent(level); out += "else\n";
+            indent(level); out += "{\n";
+            generateStatements(func, budget, level + 1, nesting + 1);
+            indent(level); out += "}\n";
+        }
+    } else if (kind < 34 && options.vectors > 0) {
+        std::string index = safeIndex(randomVariable(func));
+        indent(level);
+        out += vectorName(randomInt(0, options.vectors - 1)) + "[" + index + "] = " +
+               randomExpression(func, options.width, true) + ";\n";
+    } else if (kind < 40) {
+        indent(level); out += "print " + randomVariable(func) + ";\n";
+    } else {
+        indent(level);
+        out += randomTarget(func) + " = " + randomExpression(func, options.width, true) + ";\n";
+    }
+}
+
+// Gera um bloco de comandos com parte do orçamento restante
+static void generateStatements(FunctionInfo& func, int& budget, int level, int nesting) {
+    int count = randomInt(1, 4);
+    for (int i = 0; i < count && budget > 0; i++) {
+        generateStatement(func, budget, level, nesting);
+    }
+}
+
+static void generateFunction(int index, bool isMain) {
+    FunctionInfo func;
+    func.name = isMain ? "main" : functionName(index);
+    func.canCall = leafFunctions > 0 && (isMain || index >= leafFunctions);
+
+    int arity = isMain ? 0 : functionArity[index];
+    for (int p = 0; p < arity; p++) {
+        func.params.push_back(func.name + "_p" + std::to_string(p));
+    }
+    int localCount = randomInt(1, 3);
+    for (int l = 0; l < localCount; l++) {
+        func.locals.push_back(func.name + "_l" + std::to_string(l));
+    }
+    for (int d = 0; d < options.depth; d++) {
+        func.counters.push_back(func.name + "_i" + std::to_string(d));
+    }
+
+    out += "int " + func.name + "(";
+    for (int p = 0; p < arity; p++) {
+        if (p) out += ", ";
+        out += "int " + func.params[p];
+    }
+    out += ")\n";
+    for (const std::string& local : func.locals) {
+        out += "int " + local + " = " + std::to_string(randomInt(0, 9)) + ";\n";
+    }
+    for (const std::string& counter : func.counters) {
+        out += "int " + counter + " = 0;\n";
+    }
+    out += "{\n";
+
+    int budget = options.statements;
+    while (budget > 0) {
+        generateStatement(func, budget, 1, 0);
+    }
+
+    if (isMain) {
+        // O main chama cada função uma vez e imprime o resultado
+        for (int f = 0; f < options.functions; f++) {
+            std::string call = functionName(f) + "(";
+            for (int a = 0; a < functionArity[f]; a++) {
+                if (a) call += ", ";
+                call += std::to_string(randomInt(0, 20));
+            }
+            indent(1); out += func.locals[0] + " = " + call + ");\n";
+            indent(1); out += "print " + func.locals[0] + ";\n";
+        }
+    }
+
+    indent(1); out += "return " + randomExpression(func, options.width, false) + ";\n";
+    out += "}\n\n";
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr, "Uso: %s [opcoes] > programa.txt\n", program);
+    fprintf(stderr, "Opcoes (padrao entre parenteses):\n");
+    fprintf(stderr, "  --functions=N     funcoes alem do main (10)\n");
+    fprintf(stderr, "  --statements=N    comandos por funcao, incluindo aninhados (50)\n");
+    fprintf(stderr, "  --depth=N         profundidade maxima de if/while (3)\n");
+    fprintf(stderr, "  --width=N         operandos por expressao (4)\n");
+    fprintf(stderr, "  --globals=N       variaveis globais (10)\n");
+    fprintf(stderr, "  --vectors=N       vetores globais (2)\n");
+    fprintf(stderr, "  --vector-size=N   elementos por vetor (16)\n");
+    fprintf(stderr, "  --loop-trips=N    iteracoes de cada while (2)\n");
+    fprintf(stderr, "  --seed=N          semente do gerador aleatorio (1)\n");
+}
+
+// Lê uma opção --nome=valor inteira; retorna false se arg não é a opção
+static bool parseOption(const char* arg, const char* name, int minimum, int& value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+    value = atoi(arg + length + 1);
+    if (value < minimum) value = minimum;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        int seed = 0;
+        if (parseOption(argv[i], "--functions", 0, options.functions) ||
+            parseOption(argv[i], "--statements", 1, options.statements) ||
+            parseOption(argv[i], "--depth", 0, options.depth) ||
+            parseOption(argv[i], "--width", 1, options.width) ||
+            parseOption(argv[i], "--globals", 1, options.globals) ||
+            parseOption(argv[i], "--vectors", 0, options.vectors) ||
+            parseOption(argv[i], "--vector-size", 1, options.vectorSize) ||
+            parseOption(argv[i], "--loop-trips", 0, options.loopTrips)) {
+            continue;
+        }
+        if (parseOption(argv[i], "--seed", 0, seed)) {
+            options.seed = (unsigned)seed;
+            continue;
+        }
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    rng.seed(options.seed);
+    leafFunctions = options.functions > 0 ? (options.functions + 3) / 4 : 0;
+    for (int f = 0; f < options.functions; f++) {
+        functionArity.push_back(randomInt(0, 3));
+    }
+
+    out += "// Programa sintetico gerado por bench/generator\n\n";
+    for (int g = 0; g < options.globals; g++) {
+        out += "int " + globalName(g) + " = " + std::to_string(randomInt(0, 50)) + ";\n";
+    }
+    for (int v = 0; v < options.vectors; v++) {
+        out += "int " + vectorName(v) + "[" + std::to_string(options.vectorSize) + "];\n";
+    }
+    out += "\n";
+
+    for (int f = 0; f < options.functions; f++) {
+        generateFunction(f, false);
+    }
+    generateFunction(0, true);
+
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
@@ -0,0 +1,372 @@
+/*
+ * Compiladores - etapa7 - bench/perf_runner.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Executor dos benchmarks de tempo de execução (somente Linux): compila cada
+ * programa com o etapa7 (alvo x86-64), monta com o compilador C do sistema,
+ * executa várias vezes e mede tempo de parede, tempo de CPU e os contadores
+ * de hardware cycles, instructions, cache-misses e branch-misses via
+ * perf_event_open. O resultado é um JSON em stdout (ou em --output)
+ *
+ * Se existir <programa>.esperado ao lado do fonte, a saída de cada execução
+ * é comparada com ele. Contadores indisponíveis (perf_event_paranoid alto,
+ * máquina virtual sem PMU) são emitidos como null
+ *
+ * Uso: perf_runner [opcoes] programa.txt...
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Contadores medidos, na ordem do grupo (o primeiro é o líder)
+#define COUNTER_CYCLES          0
+#define COUNTER_INSTRUCTIONS    1
+#define COUNTER_CACHE_MISSES    2
+#define COUNTER_BRANCH_MISSES   3
+#define COUNTER_COUNT           4
+
+static const char* counterNames[COUNTER_COUNT] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+static const unsigned long long counterConfigs[COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// Opções da linha de comando
+struct RunnerOptions {
+    std::string etapa7;
+    std::string cc;
+    std::string workDir;
+    std::string output;
+    int repeat;
+
+    RunnerOptions() : etapa7("./etapa7"), cc("gcc"), repeat(5) {}
+};
+
+// Medidas de uma execução
+struct RunSample {
+    double wallMs;
+    double cpuMs;
+    long maxRssKb;
+    int exitStatus;
+    bool outputOk;
+    bool hasCounter[COUNTER_COUNT];
+    double counters[COUNTER_COUNT];
+};
+
+// Resultado de um programa
+struct BenchResult {
+    std::string name;
+    std::string status;         // "ok" ou a etapa que falhou
+    double compileMs;
+    bool hasExpected;
+    std::vector<RunSample> runs;
+};
+
+static RunnerOptions options;
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Aspas para o shell: 'texto', com ' escapado
+static std::string shellQuote(const std::string& text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        if (c == '\'') quoted += "'\\''";
+        else quoted += c;
+    }
+    return quoted + "'";
+}
+
+static bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) return false;
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+    return true;
+}
+
+// Nome do programa sem diretório e sem extensão
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+static int perfEventOpen(perf_event_attr* attr, pid_t pid, int groupFd) {
+    return (int)syscall(__NR_perf_event_open, attr, pid, -1, groupFd, 0);
+}
+
+// Abre o grupo de contadores para o processo pid, habilitados no exec;
+// fds[i] fica -1 para contadores indisponíveis
+static void openCounters(pid_t pid, int fds[COUNTER_COUNT]) {
+    int leader = -1;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = counterConfigs[i];
+        attr.disabled = leader < 0;
+        attr.enable_on_exec = leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[i] = perfEventOpen(&attr, pid, leader);
+        if (fds[i] >= 0 && leader < 0) leader = fds[i];
+    }
+}
+
+// Lê os contadores, corrigindo a multiplexação pelo tempo efetivamente
+// contado, e fecha os descritores
+static void readCounters(int fds[COUNTER_COUNT], RunSample& sample) {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        sample.hasCounter[i] = false;
+        sample.counters[i] = 0;
+        if (fds[i] < 0) continue;
+
+        unsigned long long values[3];
+        if (read(fds[i], values, sizeof(values)) == (ssize_t)sizeof(values) && values[2] > 0) {
+            sample.hasCounter[i] = true;
+            sample.counters[i] = (double)values[0] * values[1] / values[2];
+        }
+        close(fds[i]);
+    }
+}
+
+// Executa o binário uma vez, com stdout redirecionado para outputPath
+static bool runOnce(const std::string& binary, const std::string& outputPath, RunSample& sample) {
+    int ready[2];
+    if (pipe(ready) != 0) return false;
+
+    pid_t child = fork();
+    if (child < 0) return false;
+
+    if (child == 0) {
+        // Espera o pai abrir os contadores antes do exec
+        close(ready[1]);
+        char go;
+        if (read(ready[0], &go, 1) != 1) _exit(127);
+        close(ready[0]);
+
+        int out = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        int in = open("/dev/null", O_RDONLY);
+        if (out < 0 || in < 0) _exit(127);
+        dup2(out, STDOUT_FILENO);
+        dup2(in, STDIN_FILENO);
+        execl(binary.c_str(), binary.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+
+    close(ready[0]);
+    int fds[COUNTER_COUNT];
+    openCounters(child, fds);
+
+    auto start = std::chrono::steady_clock::now();
+    ssize_t written = write(ready[1], "x", 1);
+    close(ready[1]);
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) < 0) return false;
+    sample.wallMs = elapsedMs(start);
+    sample.cpuMs = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+                   (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+    sample.maxRssKb = usage.ru_maxrss;
+    sample.exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    readCounters(fds, sample);
+    return written == 1;
+}
+
+static void runBenchmark(const std::string& source, BenchResult& result) {
+    result.name = baseName(source);
+    result.compileMs = 0;
+    result.hasExpected = false;
+
+    std::string prefix = options.workDir + "/" + result.name;
+    std::string asmPath = prefix + ".s";
+    std::string binary = prefix + ".bin";
+
+    // Compila com o etapa7 e monta com o compilador C
+    auto start = std::chrono::steady_clock::now();
+    std::string command = shellQuote(options.etapa7) + " --target=x86-64 " +
+                          shellQuote(source) + " " + shellQuote(asmPath) + " > /dev/null 2>&1";
+    if (system(command.c_str()) != 0) {
+        result.status = "compile_failed";
+        return;
+    }
+    result.compileMs = elapsedMs(start);
+
+    command = shellQuote(options.cc) + " -no-pie -o " + shellQuote(binary) + " " +
+              shellQuote(asmPath) + " > /dev/null 2>&1";
+    if (system(command.c_str()) != 0) {
+        result.status = "assemble_failed";
+        return;
+    }
+
+    std::string expected;
+    size_t dot = source.find_last_of('.');
+    std::string expectedPath = (dot == std::string::npos ? source : source.substr(0, dot)) + ".esperado";
+    result.hasExpected = readFile(expectedPath, expected);
+
+    result.status = "ok";
+    for (int r = 0; r < options.repeat; r++) {
+        RunSample sample;
+        std::string outputPath = prefix + ".out";
+        if (!runOnce(binary, outputPath, sample)) {
+            result.status = "run_failed";
+            return;
+        }
+
+        std::string actual;
+        sample.outputOk = !result.hasExpected || (readFile(outputPath, actual) && actual == expected);
+        if (sample.exitStatus >= 128) result.status = "crashed";
+        else if (!sample.outputOk) result.status = "wrong_output";
+        result.runs.push_back(sample);
+    }
+}
+
+static void printJsonString(FILE* output, const std::string& text) {
+    fputc('"', output);
+    for (char c : text) {
+        if (c == '"' || c == '\\') fputc('\\', output);
+        if ((unsigned char)c < 0x20) fprintf(output, "\\u%04x", c);
+        else fputc(c, output);
+    }
+    fputc('"', output);
+}
+
+// Emite o resultado; as medidas por programa são as da execução de tempo
+// de parede mediano, e wall_ms traz também o mínimo e o máximo
+static void printResults(FILE* output, const std::vector<BenchResult>& results) {
+    fprintf(output, "{\n  \"target\": \"x86-64\",\n  \"repeat\": %d,\n  \"benchmarks\": [", options.repeat);
+
+    for (size_t b = 0; b < results.size(); b++) {
+        const BenchResult& result = results[b];
+        fprintf(output, "%s\n    {\n      \"name\": ", b ? "," : "");
+        printJsonString(output, result.name);
+        fprintf(output, ",\n      \"status\": ");
+        printJsonString(output, result.status);
+        fprintf(output, ",\n      \"compile_ms\": %.3f", result.compileMs);
+
+        if (!result.runs.empty()) {
+            std::vector<RunSample> runs = result.runs;
+            std::sort(runs.begin(), runs.end(), [](const RunSample& a, const RunSample& b) {
+                return a.wallMs < b.wallMs;
+            });
+            const RunSample& median = runs[runs.size() / 2];
+
+            fprintf(output, ",\n      \"output_checked\": %s", result.hasExpected ? "true" : "false");
+            fprintf(output, ",\n      \"wall_ms\": {\"min\": %.3f, \"median\": %.3f, \"max\": %.3f}",
+                    runs.front().wallMs, median.wallMs, runs.back().wallMs);
+            fprintf(output, ",\n      \"cpu_ms\": %.3f", median.cpuMs);
+            fprintf(output, ",\n      \"max_rss_kb\": %ld", median.maxRssKb);
+            fprintf(output, ",\n      \"exit_status\": %d", median.exitStatus);
+            for (int i = 0; i < COUNTER_COUNT; i++) {
+                if (median.hasCounter[i]) {
+                    fprintf(output, ",\n      \"%s\": %.0f", counterNames[i], median.counters[i]);
+                } else {
+                    fprintf(output, ",\n      \"%s\": null", counterNames[i]);
+                }
+            }
+            if (median.hasCounter[COUNTER_CYCLES] && median.hasCounter[COUNTER_INSTRUCTIONS] &&
+                median.counters[COUNTER_CYCLES] > 0) {
+                fprintf(output, ",\n      \"ipc\": %.3f",
+                        median.counters[COUNTER_INSTRUCTIONS] / median.counters[COUNTER_CYCLES]);
+            } else {
+                fprintf(output, ",\n      \"ipc\": null");
+            }
+        }
+        fprintf(output, "\n    }");
+    }
+    fprintf(output, "\n  ]\n}\n");
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr, "Uso: %s [opcoes] programa.txt...\n", program);
+    fprintf(stderr, "Opcoes:\n");
+    fprintf(stderr, "  --etapa7=CAMINHO   compilador etapa7 (padrao ./etapa7)\n");
+    fprintf(stderr, "  --cc=CAMINHO       montador/ligador C (padrao gcc)\n");
+    fprintf(stderr, "  --repeat=N         execucoes por programa (padrao 5)\n");
+    fprintf(stderr, "  --output=ARQUIVO   grava o JSON no arquivo em vez de stdout\n");
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> sources;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 9, "--etapa7=") == 0) {
+            options.etapa7 = arg.substr(9);
+        } else if (arg.compare(0, 5, "--cc=") == 0) {
+            options.cc = arg.substr(5);
+        } else if (arg.compare(0, 9, "--repeat=") == 0) {
+            options.repeat = std::max(1, atoi(arg.c_str() + 9));
+        } else if (arg.compare(0, 9, "--output=") == 0) {
+            options.output = arg.substr(9);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            sources.push_back(arg);
+        }
+    }
+    if (sources.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    char dirTemplate[] = "/tmp/etapa7-perf.XXXXXX";
+    if (!mkdtemp(dirTemplate)) {
+        fprintf(stderr, "Erro: nao foi possivel criar diretorio temporario: %s\n", strerror(errno));
+        return 2;
+    }
+    options.workDir = dirTemplate;
+
+    std::vector<BenchResult> results(sources.size());
+    bool allOk = true;
+    for (size_t i = 0; i < sources.size(); i++) {
+        fprintf(stderr, "[%zu/%zu] %s\n", i + 1, sources.size(), sources[i].c_str());
+        runBenchmark(sources[i], results[i]);
+        if (results[i].status != "ok") allOk = false;
+    }
+
+    std::string command = "rm -rf " + shellQuote(options.workDir);
+    if (system(command.c_str()) != 0) {
+        fprintf(stderr, "Aviso: nao foi possivel remover %s\n", options.workDir.c_str());
+    }
+
+    FILE* output = stdout;
+    if (!options.output.empty()) {
+        output = fopen(options.output.c_str(), "w");
+        if (!output) {
+            fprintf(stderr, "Erro: nao foi possivel abrir %s\n", options.output.c_str());
+            return 2;
+        }
+    }
+    printResults(output, results);
+    if (output != stdout) fclose(output);
+
+    return allOk ? 0 : 3;
+}
@@ -0,0 +1,86 @@
+#!/bin/sh
+#
+# Compiladores - etapa7 - bench/run_bench.sh - semestre 2025/2
+# Autor: Santiago Gonzaga
+#
+# Benchmark de vazão do compilador: gera programas sintéticos de tamanhos
+# crescentes com bench/generator, compila cada um com --time-report e
+# imprime linhas/segundo e o tempo (ms) de cada fase. Um crescimento mais
+# rápido que o tamanho da entrada indica um caminho quadrático
+#
+# Uso: sh bench/run_bench.sh [-t arm64|x86-64] [-r repeticoes] [tamanho...]
+#   tamanho = total de comandos do programa (padrao: 1000 2000 4000 8000 16000)
+#
+# Variáveis de ambiente: ETAPA7 (compilador, padrao ./etapa7), GENERATOR
+# (padrao bench/generator), STATEMENTS_PER_FUNCTION (padrao 100) e
+# GENERATOR_FLAGS (opcoes extras repassadas ao gerador)
+
+set -e
+
+ETAPA7=${ETAPA7:-./etapa7}
+GENERATOR=${GENERATOR:-bench/generator}
+STATEMENTS_PER_FUNCTION=${STATEMENTS_PER_FUNCTION:-100}
+TARGET=arm64
+REPEAT=1
+
+while getopts "t:r:" opt; do
+    case $opt in
+        t) TARGET=$OPTARG ;;
+        r) REPEAT=$OPTARG ;;
+        *) sed -n 's/^# Uso: //p' "$0" >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+SIZES=${*:-"1000 2000 4000 8000 16000"}
+
+if [ ! -x "$ETAPA7" ] || [ ! -x "$GENERATOR" ]; then
+    echo "Erro: compile antes com 'make etapa7 bench/generator'" >&2
+    exit 1
+fi
+
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/etapa7-bench.XXXXXX")
+trap 'rm -rf "$WORK"' EXIT
+
+for size in $SIZES; do
+    functions=$((size / STATEMENTS_PER_FUNCTION))
+    [ "$functions" -ge 1 ] || functions=1
+    statements=$((size / (functions + 1)))
+    [ "$statements" -ge 1 ] || statements=1
+
+    # shellcheck disable=SC2086
+    "$GENERATOR" --functions="$functions" --statements="$statements" \
+        $GENERATOR_FLAGS > "$WORK/prog.txt"
+    lines=$(wc -l < "$WORK/prog.txt")
+
+    # Mantém a repetição de menor tempo total
+    best=""
+    run=0
+    while [ "$run" -lt "$REPEAT" ]; do
+        "$ETAPA7" --target="$TARGET" --time-report "$WORK/prog.txt" "$WORK/prog.s" \
+            > /dev/null 2> "$WORK/report.txt"
+        total=$(sed -n 's/^Total (fases principais) *\([0-9.]*\).*/\1/p' "$WORK/report.txt")
+        if [ -z "$best" ] || awk "BEGIN { exit !($total < $best) }"; then
+            best=$total
+            cp "$WORK/report.txt" "$WORK/best.txt"
+        fi
+        run=$((run + 1))
+    done
+
+    # A coluna da fase ocupa 36 caracteres; o tempo de parede vem logo após
+    awk -v size="$size" -v lines="$lines" -v total="$best" '
+        /^===== / { inside = 1; next }
+        inside && /^Fase / { next }
+        inside && /^Total / { next }
+        inside && NF > 0 {
+            name = substr($0, 1, 36)
+            sub(/ +$/, "", name)
+            split(substr($0, 37), cols, " ")
+            phases[++count] = sprintf("    %-34s %11.3f ms", name, cols[1])
+        }
+        END {
+            rate = total > 0 ? lines / (total / 1000.0) : 0
+            printf "comandos=%d linhas=%d total=%.3f ms vazao=%.0f linhas/s\n", size, lines, total, rate
+            for (i = 1; i <= count; i++) print phases[i]
+        }' "$WORK/best.txt"
+done
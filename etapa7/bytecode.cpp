@@ -0,0 +1,288 @@
+/*
+ * Compiladores - etapa7 - bytecode.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação do bytecode: montagem da imagem a partir da forma
+ * executável do TAC (interp.hpp), validação e gravação/mapeamento em arquivo
+ */
+
+#include "bytecode.hpp"
+#include "interp.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Código do bytecode de cada instrução da forma executável (os códigos do
+// arquivo são numerados à parte, para o formato não mudar junto com o TAC)
+static int bcOpcode(int op) {
+    switch (op) {
+        case TAC_MOVE:       return BC_MOVE;
+        case TAC_ADD:        return BC_ADD;
+        case TAC_SUB:        return BC_SUB;
+        case TAC_MUL:        return BC_MUL;
+        case TAC_DIV:        return BC_DIV;
+        case TAC_MOD:        return BC_MOD;
+        case TAC_AND:        return BC_AND;
+        case TAC_OR:         return BC_OR;
+        case TAC_LT:         return BC_LT;
+        case TAC_GT:         return BC_GT;
+        case TAC_LE:         return BC_LE;
+        case TAC_GE:         return BC_GE;
+        case TAC_EQ:         return BC_EQ;
+        case TAC_DIF:        return BC_DIF;
+        case TAC_NOT:        return BC_NOT;
+        case TAC_NEG:        return BC_NEG;
+        case TAC_JUMP:       return BC_JUMP;
+        case TAC_IFZ:        return BC_IFZ;
+        case TAC_IFNZ:       return BC_IFNZ;
+        case TAC_JLT:        return BC_JLT;
+        case TAC_JGT:        return BC_JGT;
+        case TAC_JLE:        return BC_JLE;
+        case TAC_JGE:        return BC_JGE;
+        case TAC_JEQ:        return BC_JEQ;
+        case TAC_JNE:        return BC_JNE;
+        case TAC_ARG:        return BC_ARG;
+        case TAC_CALL:       return BC_CALL;
+        case TAC_RET:        return BC_RET;
+        case TAC_PRINT:      return BC_PRINT;
+        case TAC_READ:       return BC_READ;
+        case TAC_VEC_ACCESS: return BC_VEC_ACCESS;
+        case TAC_VEC_WRITE:  return BC_VEC_WRITE;
+        case TAC_VEC_READ:   return BC_VEC_READ;
+        default:             return BC_PRINT_STRING;    // INTERP_PRINT_STRING
+    }
+}
+
+// Acrescenta uma seção à imagem (tamanhos múltiplos de 4 mantêm o alinhamento)
+template <typename T>
+static void appendSection(std::vector<char>& image, const std::vector<T>& items) {
+    if (items.empty()) return;
+    const char* bytes = reinterpret_cast<const char*>(items.data());
+    image.insert(image.end(), bytes, bytes + items.size() * sizeof(T));
+}
+
+bool bytecodeCompile(TAC* tacList, std::vector<char>& image) {
+    InterpProgram program;
+    if (!interpTranslate(tacList, program)) return false;
+
+    // Texto: nomes das funções e depois os literais string, cada um
+    // terminado em '\0'
+    std::string text;
+    std::vector<BcFunction> functions;
+    std::vector<int32_t> params;
+    for (const InterpFunction& source : program.functions) {
+        BcFunction function;
+        memset(&function, 0, sizeof(function));
+        function.entry = (uint32_t)source.entry;
+        function.end = (uint32_t)source.end;
+        function.frameSize = (uint32_t)source.frameSize;
+        function.firstParam = (uint32_t)params.size();
+        function.paramCount = (uint32_t)source.params.size();
+        function.name = (uint32_t)text.size();
+        params.insert(params.end(), source.params.begin(), source.params.end());
+        text += source.name;
+        text += '\0';
+        functions.push_back(function);
+    }
+
+    std::vector<uint32_t> stringOffsets;
+    for (const std::string& string : program.strings) {
+        stringOffsets.push_back((uint32_t)text.size());
+        text += string;
+        text += '\0';
+    }
+
+    std::vector<BcInstr> code;
+    code.reserve(program.code.size());
+    for (const InterpInstr& source : program.code) {
+        BcInstr instr;
+        instr.op = bcOpcode(source.op);
+        instr.res = source.res;
+        instr.op1 = source.op1;
+        instr.op2 = source.op2;
+        if (source.op == INTERP_PRINT_STRING) {
+            // Deslocamento e tamanho do texto (até o primeiro '\0')
+            instr.op1 = (int32_t)stringOffsets[source.op1];
+            instr.op2 = (int32_t)strlen(text.c_str() + instr.op1);
+        }
+        code.push_back(instr);
+    }
+
+    std::vector<BcVector> vectors;
+    for (const InterpVector& source : program.vectors) {
+        BcVector vector;
+        vector.base = source.base;
+        vector.length = source.length;
+        vectors.push_back(vector);
+    }
+
+    BcHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = BC_MAGIC;
+    header.byteOrder = BC_BYTE_ORDER;
+    header.codeCount = (uint32_t)code.size();
+    header.functionCount = (uint32_t)functions.size();
+    header.paramCount = (uint32_t)params.size();
+    header.vectorCount = (uint32_t)vectors.size();
+    header.globalCount = (uint32_t)program.globals.size();
+    header.textBytes = (uint32_t)text.size();
+    header.mainIndex = program.mainIndex;
+    header.vectorSlots = (uint32_t)program.vectorSlots;
+
+    const char* headerBytes = reinterpret_cast<const char*>(&header);
+    image.assign(headerBytes, headerBytes + sizeof(header));
+    appendSection(image, code);
+    appendSection(image, functions);
+    appendSection(image, params);
+    appendSection(image, vectors);
+    appendSection(image, program.globals);
+    image.insert(image.end(), text.begin(), text.end());
+    return true;
+}
+
+// ==================== VALIDAÇÃO ====================
+
+// Operando de valor válido no frame dado
+static bool validOperand(int32_t operand, uint32_t frameSize, const BcHeader* header) {
+    if (operand >= 0) return (uint32_t)operand < frameSize;
+    return (uint32_t)~operand < header->globalCount;
+}
+
+// Verifica uma instrução da função: operandos dentro do frame ou da memória
+// global, desvios dentro da própria função e índices das tabelas
+static bool validInstr(const BcInstr& instr, const BcFunction& function, const BcProgram& program) {
+    const BcHeader* header = program.header;
+    uint32_t frame = function.frameSize;
+    bool target = instr.res >= (int32_t)function.entry && instr.res < (int32_t)function.end;
+
+    switch (instr.op) {
+        case BC_MOVE: case BC_NOT: case BC_NEG:
+            return validOperand(instr.res, frame, header) && validOperand(instr.op1, frame, header);
+        case BC_ADD: case BC_SUB: case BC_MUL: case BC_DIV: case BC_MOD: case BC_AND: case BC_OR:
+        case BC_LT: case BC_GT: case BC_LE: case BC_GE: case BC_EQ: case BC_DIF:
+            return validOperand(instr.res, frame, header) && validOperand(instr.op1, frame, header) &&
+                   validOperand(instr.op2, frame, header);
+        case BC_JUMP:
+            return target;
+        case BC_IFZ: case BC_IFNZ:
+            return target && validOperand(instr.op1, frame, header);
+        case BC_JLT: case BC_JGT: case BC_JLE: case BC_JGE: case BC_JEQ: case BC_JNE:
+            return target && validOperand(instr.op1, frame, header) && validOperand(instr.op2, frame, header);
+        case BC_ARG: case BC_RET: case BC_PRINT:
+            return validOperand(instr.op1, frame, header);
+        case BC_CALL:
+            return validOperand(instr.res, frame, header) && instr.op1 >= 0 &&
+                   (uint32_t)instr.op1 < header->functionCount;
+        case BC_PRINT_STRING:
+            return instr.op1 >= 0 && instr.op2 >= 0 &&
+                   (uint64_t)instr.op1 + (uint64_t)instr.op2 <= header->textBytes;
+        case BC_READ:
+            return validOperand(instr.res, frame, header);
+        case BC_VEC_ACCESS:
+            return validOperand(instr.res, frame, header) && instr.op1 >= 0 &&
+                   (uint32_t)instr.op1 < header->vectorCount && validOperand(instr.op2, frame, header);
+        case BC_VEC_WRITE:
+            return instr.res >= 0 && (uint32_t)instr.res < header->vectorCount &&
+                   validOperand(instr.op1, frame, header) && validOperand(instr.op2, frame, header);
+        case BC_VEC_READ:
+            return instr.res >= 0 && (uint32_t)instr.res < header->vectorCount &&
+                   validOperand(instr.op1, frame, header);
+        default:
+            return false;
+    }
+}
+
+bool bytecodeLoad(char* image, size_t size, BcProgram& program) {
+    if (!image || size < sizeof(BcHeader) || reinterpret_cast<uintptr_t>(image) % 4 != 0) return false;
+
+    const BcHeader* header = reinterpret_cast<const BcHeader*>(image);
+    if (header->magic != BC_MAGIC || header->byteOrder != BC_BYTE_ORDER) return false;
+
+    uint64_t expected = sizeof(BcHeader) +
+                        (uint64_t)header->codeCount * sizeof(BcInstr) +
+                        (uint64_t)header->functionCount * sizeof(BcFunction) +
+                        (uint64_t)header->paramCount * sizeof(int32_t) +
+                        (uint64_t)header->vectorCount * sizeof(BcVector) +
+                        (uint64_t)header->globalCount * sizeof(int32_t) +
+                        header->textBytes;
+    if (expected != size) return false;
+    if (header->mainIndex < 0 || (uint32_t)header->mainIndex >= header->functionCount) return false;
+    if (header->textBytes == 0 || image[size - 1] != '\0') return false;
+
+    char* p = image + sizeof(BcHeader);
+    program.header = header;
+    program.code = reinterpret_cast<const BcInstr*>(p);
+    p += header->codeCount * sizeof(BcInstr);
+    program.functions = reinterpret_cast<const BcFunction*>(p);
+    p += header->functionCount * sizeof(BcFunction);
+    program.params = reinterpret_cast<const int32_t*>(p);
+    p += header->paramCount * sizeof(int32_t);
+    program.vectors = reinterpret_cast<const BcVector*>(p);
+    p += header->vectorCount * sizeof(BcVector);
+    program.globals = reinterpret_cast<int32_t*>(p);
+    p += header->globalCount * sizeof(int32_t);
+    program.text = p;
+
+    for (uint32_t v = 0; v < header->vectorCount; v++) {
+        const BcVector& vector = program.vectors[v];
+        if (vector.base < 0 || vector.length < 1 ||
+            (uint64_t)vector.base + (uint64_t)vector.length > header->vectorSlots) return false;
+    }
+
+    // Cada função termina em return ou desvio, de modo que a execução nunca
+    // sai do seu trecho de código
+    for (uint32_t f = 0; f < header->functionCount; f++) {
+        const BcFunction& function = program.functions[f];
+        if (function.entry >= function.end || function.end > header->codeCount) return false;
+        if (function.name >= header->textBytes) return false;
+        if ((uint64_t)function.firstParam + function.paramCount > header->paramCount) return false;
+        for (uint32_t i = 0; i < function.paramCount; i++) {
+            if (!validOperand(program.params[function.firstParam + i], function.frameSize, header)) return false;
+        }
+
+        for (uint32_t i = function.entry; i < function.end; i++) {
+            if (!validInstr(program.code[i], function, program)) return false;
+        }
+        int last = program.code[function.end - 1].op;
+        if (last != BC_RET && last != BC_JUMP) return false;
+    }
+    return true;
+}
+
+// ==================== ARQUIVOS ====================
+
+bool bytecodeSave(const std::vector<char>& image, const char* fileName) {
+    FILE* file = fopen(fileName, "wb");
+    if (!file) return false;
+    bool ok = fwrite(image.data(), 1, image.size(), file) == image.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool bytecodeMap(const char* fileName, BcMapping& mapping) {
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    mapping.data = static_cast<char*>(data);
+    mapping.size = (size_t)info.st_size;
+    return true;
+}
+
+void bytecodeUnmap(BcMapping& mapping) {
+    if (mapping.data) munmap(mapping.data, mapping.size);
+    mapping.data = nullptr;
+    mapping.size = 0;
+}
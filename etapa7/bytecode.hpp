@@ -0,0 +1,140 @@
+/*
+ * Compiladores - etapa7 - bytecode.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições do bytecode de registradores: o TAC de cada função vira um
+ * vetor de instruções de largura fixa cujos operandos são índices de slots
+ * (do frame da ativação ou da memória global). O programa inteiro fica em
+ * uma única imagem contígua, sem ponteiros, que pode ser gravada em arquivo
+ * e depois mapeada com mmap e executada sem nenhuma tradução
+ */
+
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include "tac.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Instruções. Operandos de valor: >= 0 é um slot do frame da ativação
+// corrente, < 0 é o slot ~x da memória global (variáveis globais,
+// constantes e literais)
+#define BC_MOVE          0   // res = op1
+#define BC_ADD           1   // res = op1 + op2 (aritmética em 32 bits)
+#define BC_SUB           2   // res = op1 - op2
+#define BC_MUL           3   // res = op1 * op2
+#define BC_DIV           4   // res = op1 / op2
+#define BC_MOD           5   // res = op1 % op2
+#define BC_AND           6   // res = op1 & op2
+#define BC_OR            7   // res = op1 | op2
+#define BC_LT            8   // res = op1 < op2
+#define BC_GT            9   // res = op1 > op2
+#define BC_LE            10  // res = op1 <= op2
+#define BC_GE            11  // res = op1 >= op2
+#define BC_EQ            12  // res = op1 == op2
+#define BC_DIF           13  // res = op1 != op2
+#define BC_NOT           14  // res = !op1
+#define BC_NEG           15  // res = -op1
+#define BC_JUMP          16  // goto res (índice da instrução)
+#define BC_IFZ           17  // if op1 == 0 goto res
+#define BC_IFNZ          18  // if op1 != 0 goto res
+#define BC_JLT           19  // if op1 < op2 goto res
+#define BC_JGT           20  // if op1 > op2 goto res
+#define BC_JLE           21  // if op1 <= op2 goto res
+#define BC_JGE           22  // if op1 >= op2 goto res
+#define BC_JEQ           23  // if op1 == op2 goto res
+#define BC_JNE           24  // if op1 != op2 goto res
+#define BC_ARG           25  // empilha op1 como argumento da próxima chamada
+#define BC_CALL          26  // res = chamada da função op1
+#define BC_RET           27  // retorna op1
+#define BC_PRINT         28  // imprime op1 em decimal
+#define BC_PRINT_STRING  29  // imprime op2 bytes do texto a partir de op1
+#define BC_READ          30  // lê um inteiro em res
+#define BC_VEC_ACCESS    31  // res = vetor op1 [op2]
+#define BC_VEC_WRITE     32  // vetor res [op1] = op2
+#define BC_VEC_READ      33  // lê um inteiro em vetor res [op1]
+#define BC_OPCODES       34
+
+// Identificação da imagem ("ETB" e versão do formato) e marca de ordem dos
+// bytes (a imagem usa a ordem da máquina que a gerou)
+#define BC_MAGIC         0x31425445u
+#define BC_BYTE_ORDER    0x01020304u
+
+// Instrução de largura fixa (16 bytes)
+struct BcInstr {
+    int32_t op;
+    int32_t res;
+    int32_t op1;
+    int32_t op2;
+};
+
+struct BcFunction {
+    uint32_t entry;         // Primeira instrução
+    uint32_t end;           // Instrução seguinte à última
+    uint32_t frameSize;     // Slots de locais e temporários
+    uint32_t firstParam;    // Operandos dos parâmetros em params[firstParam..]
+    uint32_t paramCount;
+    uint32_t name;          // Deslocamento do nome (terminado em '\0') no texto
+};
+
+struct BcVector {
+    int32_t base;           // Primeiro slot na área dos vetores
+    int32_t length;
+};
+
+// Cabeçalho da imagem; seguem, nesta ordem e alinhados em 4 bytes, as
+// instruções, funções, operandos dos parâmetros, vetores, valores iniciais
+// da memória global e o texto (strings e nomes das funções). Os vetores
+// ficam em uma área à parte, zerada na execução e ausente da imagem (como
+// a seção .bss)
+struct BcHeader {
+    uint32_t magic;
+    uint32_t byteOrder;
+    uint32_t codeCount;
+    uint32_t functionCount;
+    uint32_t paramCount;
+    uint32_t vectorCount;
+    uint32_t globalCount;
+    uint32_t textBytes;
+    int32_t mainIndex;
+    uint32_t vectorSlots;   // Tamanho da área dos vetores
+};
+
+// Programa sobre uma imagem (sem cópia: os ponteiros apontam para dentro
+// dela). A memória global é alterada durante a execução
+struct BcProgram {
+    const BcHeader* header;
+    const BcInstr* code;
+    const BcFunction* functions;
+    const int32_t* params;
+    const BcVector* vectors;
+    int32_t* globals;
+    const char* text;
+};
+
+// Traduz o programa (lista de TACs invertida, como em generateAsm) para a
+// forma executável (interpTranslate) e grava essa forma em uma imagem.
+// Retorna false (com a mensagem em stderr) se a tradução falhar
+bool bytecodeCompile(TAC* tacList, std::vector<char>& image);
+
+// Valida a imagem (tamanhos, operandos, destinos de desvio) e preenche
+// program com ponteiros para dentro dela; image deve estar alinhada em 4
+bool bytecodeLoad(char* image, size_t size, BcProgram& program);
+
+// Grava a imagem em arquivo
+bool bytecodeSave(const std::vector<char>& image, const char* fileName);
+
+// Imagem mapeada de um arquivo (cópia privada: as escritas na memória
+// global não voltam ao arquivo)
+struct BcMapping {
+    char* data;
+    size_t size;
+
+    BcMapping() : data(nullptr), size(0) {}
+};
+
+bool bytecodeMap(const char* fileName, BcMapping& mapping);
+void bytecodeUnmap(BcMapping& mapping);
+
+#endif // BYTECODE_HPP
@@ -0,0 +1,154 @@
+/*
+ * Compiladores - etapa7 - cfg.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Construção de blocos básicos e do grafo de fluxo de controle em tempo
+ * linear no tamanho da função, para poder ser refeito após cada
+ * transformação do TAC
+ */
+
+#include "cfg.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+bool tacEndsBlock(TAC* tac) {
+    if (!tac) return false;
+    return tacIsJump(tac) || tac->type == TAC_RET;
+}
+
+void buildCFG(TAC* beginFun, CFG& cfg) {
+    std::vector<TAC*> funcTacs;
+    for (TAC* t = beginFun; t; t = t->next) {
+        funcTacs.push_back(t);
+        if (t->type == TAC_ENDFUN) break;
+    }
+    buildCFG(funcTacs, cfg);
+}
+
+void buildCFG(const std::vector<TAC*>& funcTacs, CFG& cfg) {
+    cfg.tacs = funcTacs;
+    cfg.blocks.clear();
+    cfg.blockOf.assign(funcTacs.size(), 0);
+
+    int n = (int)funcTacs.size();
+    if (n == 0) return;
+
+    // Líderes: primeira instrução, labels e instruções após desvios/retornos
+    std::unordered_map<SymbolNode*, int> labelBlock;
+    for (int i = 0; i < n; i++) {
+        TAC* t = funcTacs[i];
+        bool leader = (i == 0) || t->type == TAC_LABEL || tacEndsBlock(funcTacs[i - 1]);
+        if (leader) {
+            if (!cfg.blocks.empty()) cfg.blocks.back().last = i - 1;
+            cfg.blocks.push_back(BasicBlock());
+            cfg.blocks.back().first = i;
+        }
+        int block = (int)cfg.blocks.size() - 1;
+        cfg.blockOf[i] = block;
+        if (t->type == TAC_LABEL && t->res) {
+            labelBlock[t->res] = block;
+        }
+    }
+    cfg.blocks.back().last = n - 1;
+
+    // Arestas: alvo do desvio e/ou bloco seguinte (fall-through)
+    int blockCount = (int)cfg.blocks.size();
+    for (int b = 0; b < blockCount; b++) {
+        TAC* last = funcTacs[cfg.blocks[b].last];
+
+        if (tacIsJump(last)) {
+            auto it = labelBlock.find(last->res);
+            if (it != labelBlock.end()) {
+                cfg.blocks[b].successors.push_back(it->second);
+            }
+        }
+
+        bool fallsThrough = last->type != TAC_JUMP && last->type != TAC_RET &&
+                            last->type != TAC_ENDFUN;
+        if (fallsThrough && b + 1 < blockCount) {
+            // Desvio para o próprio bloco seguinte gera uma única aresta
+            if (cfg.blocks[b].successors.empty() || cfg.blocks[b].successors[0] != b + 1) {
+                cfg.blocks[b].successors.push_back(b + 1);
+            }
+        }
+    }
+
+    for (int b = 0; b < blockCount; b++) {
+        for (int s : cfg.blocks[b].successors) {
+            cfg.blocks[s].predecessors.push_back(b);
+        }
+    }
+}
+
+void CFG::reversePostorder(std::vector<int>& order) const {
+    order.clear();
+    int count = blockCount();
+    if (count == 0) return;
+
+    // Busca em profundidade iterativa: (bloco, próximo sucessor a visitar)
+    std::vector<bool> visited(count, false);
+    std::vector<std::pair<int, size_t>> stack;
+    stack.push_back(std::make_pair(0, (size_t)0));
+    visited[0] = true;
+
+    while (!stack.empty()) {
+        int block = stack.back().first;
+        size_t& next = stack.back().second;
+        if (next < blocks[block].successors.size()) {
+            int s = blocks[block].successors[next++];
+            if (!visited[s]) {
+                visited[s] = true;
+                stack.push_back(std::make_pair(s, (size_t)0));
+            }
+        } else {
+            order.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+}
+
+void computeDominators(const CFG& cfg, std::vector<int>& idom) {
+    int count = cfg.blockCount();
+    idom.assign(count, -1);
+    if (count == 0) return;
+
+    std::vector<int> order;
+    cfg.reversePostorder(order);
+    std::vector<int> rank(count, -1);
+    for (size_t i = 0; i < order.size(); i++) rank[order[i]] = (int)i;
+
+    // Interseção subindo pelos dominadores já calculados até o ancestral comum
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (rank[a] > rank[b]) a = idom[a];
+            while (rank[b] > rank[a]) b = idom[b];
+        }
+        return a;
+    };
+
+    idom[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); i++) {
+            int b = order[i];
+            int dominator = -1;
+            for (int p : cfg.blocks[b].predecessors) {
+                if (idom[p] < 0) continue;
+                dominator = dominator < 0 ? p : intersect(p, dominator);
+            }
+            if (dominator != idom[b]) {
+                idom[b] = dominator;
+                changed = true;
+            }
+        }
+    }
+}
+
+bool dominates(const std::vector<int>& idom, int a, int b) {
+    if (idom[a] < 0 || idom[b] < 0) return false;
+    while (b != a && b != 0) b = idom[b];
+    return b == a;
+}
@@ -0,0 +1,62 @@
+/*
+ * Compiladores - etapa7 - cfg.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições para blocos básicos e grafo de fluxo de controle (CFG) de uma
+ * função do TAC
+ */
+
+#ifndef CFG_HPP
+#define CFG_HPP
+
+#include "tac.hpp"
+#include <vector>
+
+// Bloco básico: sequência de instruções [first, last] (posições em
+// CFG::tacs) executada sempre do início ao fim
+struct BasicBlock {
+    int first;                      // Posição da primeira instrução (líder)
+    int last;                       // Posição da última instrução
+    std::vector<int> successors;    // Blocos que podem executar em seguida
+    std::vector<int> predecessors;  // Blocos que podem executar antes
+
+    BasicBlock() : first(0), last(-1) {}
+
+    int size() const { return last - first + 1; }
+};
+
+// Grafo de fluxo de controle de uma função (de TAC_BEGINFUN a TAC_ENDFUN)
+// O bloco 0 é a entrada; os blocos ficam na ordem do código
+struct CFG {
+    std::vector<TAC*> tacs;         // Instruções da função em ordem de execução
+    std::vector<BasicBlock> blocks; // Blocos básicos
+    std::vector<int> blockOf;       // Posição da instrução -> bloco
+
+    int blockCount() const { return (int)blocks.size(); }
+
+    // Instrução na posição dada
+    TAC* at(int position) const { return tacs[position]; }
+
+    // Blocos em pós-ordem reversa a partir da entrada (blocos inalcançáveis
+    // ficam de fora) - ordem natural para análises para frente
+    void reversePostorder(std::vector<int>& order) const;
+};
+
+// Constrói o CFG a partir das instruções de uma função, em ordem de execução
+void buildCFG(const std::vector<TAC*>& funcTacs, CFG& cfg);
+
+// Constrói o CFG seguindo os ponteiros next a partir de um TAC_BEGINFUN,
+// até o TAC_ENDFUN correspondente
+void buildCFG(TAC* beginFun, CFG& cfg);
+
+// Instruções que encerram um bloco básico (desvios e retorno)
+bool tacEndsBlock(TAC* tac);
+
+// Dominador imediato de cada bloco (Cooper, Harvey e Kennedy): idom[0] = 0
+// e blocos inalcançáveis ficam com -1
+void computeDominators(const CFG& cfg, std::vector<int>& idom);
+
+// Indica se o bloco a domina o bloco b (ambos alcançáveis)
+bool dominates(const std::vector<int>& idom, int a, int b);
+
+#endif // CFG_HPP
@@ -0,0 +1,337 @@
+/*
+ * Compiladores - etapa7 - dataflow.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Resolvedor de fluxo de dados e análises construídas sobre ele. Os
+ * conjuntos por bloco só têm bits para o que pode atravessar a fronteira
+ * entre blocos, para que funções com dezenas de milhares de temporários
+ * (quase todos locais a um bloco) tenham vetores pequenos
+ */
+
+#include "dataflow.hpp"
+#include <algorithm>
+
+// ==================== RESOLVEDOR ====================
+
+DataflowProblem::DataflowProblem(const CFG& cfg, int flow, int meetOperator, int universe)
+    : direction(flow), meet(meetOperator), bits(universe), words(BITSET_WORDS(universe)),
+      gen(cfg.blockCount() * words, 0), kill(cfg.blockCount() * words, 0),
+      boundary(words, 0) {}
+
+void solveDataflow(const CFG& cfg, const DataflowProblem& problem,
+                   std::vector<uint64_t>& in, std::vector<uint64_t>& out) {
+    int count = cfg.blockCount();
+    int words = problem.words;
+    bool forward = problem.direction == DATAFLOW_FORWARD;
+    bool intersection = problem.meet == DATAFLOW_INTERSECTION;
+
+    in.assign(count * words, 0);
+    out.assign(count * words, 0);
+    if (count == 0 || words == 0) return;
+
+    // Identidade do encontro: universo inteiro (sem bits além de bits) para
+    // a interseção, vazio para a união
+    std::vector<uint64_t> identity(words, intersection ? ~(uint64_t)0 : 0);
+    if (intersection && problem.bits % 64) {
+        identity[words - 1] = ((uint64_t)1 << (problem.bits % 64)) - 1;
+    }
+
+    // Conjunto propagado (saída para frente, entrada para trás) começa na
+    // identidade, para que blocos ainda não visitados não restrinjam nada
+    std::vector<uint64_t>& result = forward ? out : in;
+    std::vector<uint64_t>& merged = forward ? in : out;
+    for (int b = 0; b < count; b++) {
+        std::copy(identity.begin(), identity.end(), result.begin() + b * words);
+    }
+
+    std::vector<int> order;
+    cfg.reversePostorder(order);
+    std::vector<bool> reachable(count, false);
+    for (int b : order) reachable[b] = true;
+    for (int b = 0; b < count; b++) {
+        if (!reachable[b]) order.push_back(b);
+    }
+    if (!forward) std::reverse(order.begin(), order.end());
+
+    std::vector<char> pending(count, 1);
+    bool again = true;
+    while (again) {
+        again = false;
+        for (int b : order) {
+            if (!pending[b]) continue;
+            pending[b] = 0;
+
+            const BasicBlock& block = cfg.blocks[b];
+            const std::vector<int>& sources = forward ? block.predecessors : block.successors;
+            const std::vector<int>& targets = forward ? block.successors : block.predecessors;
+            uint64_t* meetSet = &merged[b * words];
+
+            // Encontro dos vizinhos (e da fronteira da função)
+            bool empty = true;
+            if (forward ? b == 0 : sources.empty()) {
+                std::copy(problem.boundary.begin(), problem.boundary.end(), meetSet);
+                empty = false;
+            }
+            for (int s : sources) {
+                const uint64_t* value = &result[s * words];
+                if (empty) {
+                    std::copy(value, value + words, meetSet);
+                    empty = false;
+                } else if (intersection) {
+                    for (int w = 0; w < words; w++) meetSet[w] &= value[w];
+                } else {
+                    for (int w = 0; w < words; w++) meetSet[w] |= value[w];
+                }
+            }
+            if (empty) std::copy(identity.begin(), identity.end(), meetSet);
+
+            // Transferência
+            const uint64_t* gen = &problem.gen[b * words];
+            const uint64_t* kill = &problem.kill[b * words];
+            uint64_t* value = &result[b * words];
+            uint64_t differ = 0;
+            for (int w = 0; w < words; w++) {
+                uint64_t next = gen[w] | (meetSet[w] & ~kill[w]);
+                differ |= next ^ value[w];
+                value[w] = next;
+            }
+            if (differ) {
+                for (int t : targets) pending[t] = 1;
+                again = again || !targets.empty();
+            }
+        }
+    }
+}
+
+// ==================== NUMERAÇÃO ====================
+
+void numberSymbols(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                   bool includeTemps, SymbolIndex& numbering) {
+    numbering.index.clear();
+    numbering.symbols.clear();
+    numbering.operands.assign(cfg.tacs.size() * 3, -1);
+    numbering.boundaryCount = 0;
+
+    // Numeração provisória na ordem de aparição, marcando os lidos antes de
+    // escritos em algum bloco
+    std::vector<int> writtenIn;     // Índice -> último bloco que o escreveu
+    std::vector<bool> exposed;
+    auto number = [&](SymbolNode* sym) -> int {
+        if (!sym) return -1;
+        auto it = numbering.index.find(sym);
+        if (it != numbering.index.end()) return it->second;
+        if (!(includeTemps && sym->type == SYMBOL_TEMP) && !tracked.count(sym)) return -1;
+        int i = numbering.size();
+        numbering.index[sym] = i;
+        numbering.symbols.push_back(sym);
+        writtenIn.push_back(-1);
+        exposed.push_back(false);
+        return i;
+    };
+
+    SymbolNode* uses[2];
+    for (int i = 0; i < (int)cfg.tacs.size(); i++) {
+        TAC* t = cfg.tacs[i];
+        int block = cfg.blockOf[i];
+        int* operands = &numbering.operands[i * 3];
+        int count = tacUses(t, uses);
+        for (int u = 0; u < count; u++) {
+            int s = number(uses[u]);
+            if (s >= 0 && writtenIn[s] != block) exposed[s] = true;
+            operands[1 + u] = s;
+        }
+        int d = number(tacDefinition(t));
+        if (d >= 0 && t->type != TAC_READ) writtenIn[d] = block;
+        operands[0] = d;
+    }
+
+    // Os expostos primeiro, mantendo a ordem de aparição
+    int size = numbering.size();
+    std::vector<int> remap(size);
+    int next = 0;
+    for (int i = 0; i < size; i++) {
+        if (exposed[i]) remap[i] = next++;
+    }
+    numbering.boundaryCount = next;
+    for (int i = 0; i < size; i++) {
+        if (!exposed[i]) remap[i] = next++;
+    }
+    std::vector<SymbolNode*> ordered(size);
+    for (int i = 0; i < size; i++) ordered[remap[i]] = numbering.symbols[i];
+    numbering.symbols.swap(ordered);
+    for (auto& pair : numbering.index) pair.second = remap[pair.second];
+    for (int& operand : numbering.operands) {
+        if (operand >= 0) operand = remap[operand];
+    }
+}
+
+// ==================== VIVÊNCIA ====================
+
+void computeLiveness(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                     bool includeTemps, Liveness& liveness) {
+    numberSymbols(cfg, tracked, includeTemps, liveness.symbols);
+    const SymbolIndex& symbols = liveness.symbols;
+    DataflowProblem problem(cfg, DATAFLOW_BACKWARD, DATAFLOW_UNION, symbols.boundaryCount);
+    liveness.words = problem.words;
+
+    // gen: lidos antes de escritos no bloco; kill: escritos (read não mata)
+    if (problem.words > 0) {
+        for (int i = 0; i < (int)cfg.tacs.size(); i++) {
+            uint64_t* gen = problem.genOf(cfg.blockOf[i]);
+            uint64_t* kill = problem.killOf(cfg.blockOf[i]);
+
+            const int* uses = symbols.usesAt(i);
+            for (int u = 0; u < 2; u++) {
+                if (symbols.crossesBlocks(uses[u]) && !bitTest(kill, uses[u])) bitSet(gen, uses[u]);
+            }
+            int s = symbols.definitionAt(i);
+            if (symbols.crossesBlocks(s) && cfg.tacs[i]->type != TAC_READ) bitSet(kill, s);
+        }
+    }
+
+    solveDataflow(cfg, problem, liveness.liveIn, liveness.liveOut);
+}
+
+// ==================== DEFINIÇÕES QUE ALCANÇAM ====================
+
+void computeReachingDefinitions(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                                bool includeTemps, ReachingDefinitions& reaching) {
+    numberSymbols(cfg, tracked, includeTemps, reaching.symbols);
+    const SymbolIndex& symbols = reaching.symbols;
+    int boundary = symbols.boundaryCount;
+    int n = (int)cfg.tacs.size();
+
+    // Definições de entrada, uma por símbolo, e depois as instruções
+    reaching.site.assign(boundary, -1);
+    reaching.symbolOf.resize(boundary);
+    reaching.ofSymbol.assign(boundary, std::vector<int>());
+    for (int s = 0; s < boundary; s++) {
+        reaching.symbolOf[s] = s;
+        reaching.ofSymbol[s].push_back(s);
+    }
+    std::vector<int> definitionAt(n, -1);
+    for (int i = 0; i < n; i++) {
+        int s = symbols.definitionAt(i);
+        if (!symbols.crossesBlocks(s)) continue;
+        int d = (int)reaching.site.size();
+        reaching.site.push_back(i);
+        reaching.symbolOf.push_back(s);
+        reaching.ofSymbol[s].push_back(d);
+        definitionAt[i] = d;
+    }
+
+    DataflowProblem problem(cfg, DATAFLOW_FORWARD, DATAFLOW_UNION, (int)reaching.site.size());
+    reaching.words = problem.words;
+    for (int s = 0; s < boundary; s++) bitSet(&problem.boundary[0], s);
+
+    // De trás para frente em cada bloco: a última escrita de um símbolo que
+    // não é read mata todas as outras; os reads depois dela também saem
+    std::vector<int> killedIn(boundary, -1);
+    for (int b = 0; b < cfg.blockCount(); b++) {
+        uint64_t* gen = problem.genOf(b);
+        uint64_t* kill = problem.killOf(b);
+        for (int i = cfg.blocks[b].last; i >= cfg.blocks[b].first; i--) {
+            int d = definitionAt[i];
+            if (d < 0) continue;
+            int s = reaching.symbolOf[d];
+            if (killedIn[s] == b) continue;
+            bitSet(gen, d);
+            if (cfg.tacs[i]->type == TAC_READ) continue;
+            killedIn[s] = b;
+            for (int other : reaching.ofSymbol[s]) bitSet(kill, other);
+        }
+    }
+
+    solveDataflow(cfg, problem, reaching.reachIn, reaching.reachOut);
+}
+
+// ==================== EXPRESSÕES DISPONÍVEIS ====================
+
+static bool isExpressionType(int type) {
+    switch (type) {
+        case TAC_ADD: case TAC_SUB: case TAC_MUL: case TAC_DIV: case TAC_MOD:
+        case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+        case TAC_AND: case TAC_OR: case TAC_NOT: case TAC_NEG:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int AvailableExpressions::indexOf(TAC* tac) const {
+    if (!tac || !isExpressionType(tac->type)) return -1;
+    Expression e = {tac->type, tac->op1, tac->op2, tac->res};
+    auto it = index.find(e);
+    return it != index.end() ? it->second : -1;
+}
+
+void computeAvailableExpressions(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                                 bool includeTemps, AvailableExpressions& available) {
+    numberSymbols(cfg, tracked, includeTemps, available.symbols);
+    const SymbolIndex& symbols = available.symbols;
+    int n = (int)cfg.tacs.size();
+
+    available.expressions.clear();
+    available.index.clear();
+    available.usersOf.assign(symbols.boundaryCount, std::vector<int>());
+
+    // Um operando local a um bloco é sempre escrito antes da expressão no
+    // mesmo bloco, então ela nunca chega disponível a uma entrada
+    auto crosses = [&](SymbolNode* sym) {
+        return !sym || isConstant(sym) || symbols.crossesBlocks(symbols.indexOf(sym));
+    };
+
+    // Um resultado escrito uma única vez só pode ter sido escrito pela
+    // própria expressão (nenhuma escrita o mata depois dela)
+    std::vector<int> definitions(symbols.size(), 0);
+    for (int i = 0; i < n; i++) {
+        int s = symbols.definitionAt(i);
+        if (s >= 0) definitions[s]++;
+    }
+    auto holds = [&](TAC* t) {
+        int r = symbols.indexOf(t->res);
+        return r >= 0 && definitions[r] == 1 && t->res != t->op1 && t->res != t->op2;
+    };
+
+    std::vector<int> expressionAt(n, -1);
+    for (int i = 0; i < n; i++) {
+        TAC* t = cfg.tacs[i];
+        if (!isExpressionType(t->type) || !crosses(t->op1) || !crosses(t->op2) || !holds(t)) continue;
+        Expression e = {t->type, t->op1, t->op2, t->res};
+        auto it = available.index.find(e);
+        if (it != available.index.end()) {
+            expressionAt[i] = it->second;
+            continue;
+        }
+        int id = (int)available.expressions.size();
+        available.expressions.push_back(e);
+        available.index[e] = id;
+        expressionAt[i] = id;
+        int s1 = symbols.indexOf(t->op1);
+        int s2 = symbols.indexOf(t->op2);
+        if (s1 >= 0) available.usersOf[s1].push_back(id);
+        if (s2 >= 0 && s2 != s1) available.usersOf[s2].push_back(id);
+    }
+
+    DataflowProblem problem(cfg, DATAFLOW_FORWARD, DATAFLOW_INTERSECTION,
+                            (int)available.expressions.size());
+    available.words = problem.words;
+
+    // Para frente em cada bloco: a expressão é gerada e depois a escrita do
+    // resultado (ou um read) mata as que leem o símbolo escrito
+    if (problem.words > 0) {
+        for (int i = 0; i < n; i++) {
+            uint64_t* gen = problem.genOf(cfg.blockOf[i]);
+            uint64_t* kill = problem.killOf(cfg.blockOf[i]);
+            if (expressionAt[i] >= 0) bitSet(gen, expressionAt[i]);
+            int s = symbols.definitionAt(i);
+            if (!symbols.crossesBlocks(s)) continue;
+            for (int e : available.usersOf[s]) {
+                bitClear(gen, e);
+                bitSet(kill, e);
+            }
+        }
+    }
+
+    solveDataflow(cfg, problem, available.availableIn, available.availableOut);
+}
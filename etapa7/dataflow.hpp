@@ -0,0 +1,211 @@
+/*
+ * Compiladores - etapa7 - dataflow.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições do arcabouço de análise de fluxo de dados sobre o CFG de uma
+ * função: conjuntos de bits por bloco (palavras de 64 bits), um resolvedor
+ * genérico para frente ou para trás e as análises de vivência, definições
+ * que alcançam e expressões disponíveis
+ */
+
+#ifndef DATAFLOW_HPP
+#define DATAFLOW_HPP
+
+#include "cfg.hpp"
+#include "tac.hpp"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// ==================== CONJUNTOS DE BITS ====================
+
+// Palavras para n bits
+#define BITSET_WORDS(n)     (((n) + 63) / 64)
+
+inline bool bitTest(const uint64_t* set, int i) {
+    return (set[i / 64] >> (i % 64)) & 1;
+}
+
+inline void bitSet(uint64_t* set, int i) {
+    set[i / 64] |= (uint64_t)1 << (i % 64);
+}
+
+inline void bitClear(uint64_t* set, int i) {
+    set[i / 64] &= ~((uint64_t)1 << (i % 64));
+}
+
+// ==================== RESOLVEDOR ====================
+
+#define DATAFLOW_FORWARD        0   // Entrada de um bloco vem dos predecessores
+#define DATAFLOW_BACKWARD       1   // Saída de um bloco vem dos sucessores
+
+#define DATAFLOW_UNION          0   // Vale em algum caminho ("pode")
+#define DATAFLOW_INTERSECTION   1   // Vale em todos os caminhos ("deve")
+
+// Problema de fluxo de dados com transferência gen | (x & ~kill) em cada
+// bloco: para frente, out = gen | (in & ~kill); para trás,
+// in = gen | (out & ~kill). gen e kill têm words palavras por bloco
+struct DataflowProblem {
+    int direction;
+    int meet;
+    int bits;                       // Tamanho do universo
+    int words;                      // BITSET_WORDS(bits)
+    std::vector<uint64_t> gen;
+    std::vector<uint64_t> kill;
+    std::vector<uint64_t> boundary; // Entrada do bloco 0 (para frente) ou
+                                    // saída dos blocos sem sucessor (para trás)
+
+    DataflowProblem(const CFG& cfg, int direction, int meet, int bits);
+
+    uint64_t* genOf(int block) { return &gen[block * words]; }
+    uint64_t* killOf(int block) { return &kill[block * words]; }
+};
+
+// Resolve até o ponto fixo com lista de trabalho em pós-ordem reversa
+// (para frente) ou pós-ordem (para trás); blocos inalcançáveis vêm por
+// último. in e out recebem words palavras por bloco
+void solveDataflow(const CFG& cfg, const DataflowProblem& problem,
+                   std::vector<uint64_t>& in, std::vector<uint64_t>& out);
+
+// ==================== NUMERAÇÃO ====================
+
+// Numeração densa dos símbolos acompanhados em uma função. Os que são lidos
+// em algum bloco antes de serem escritos nele (os únicos que podem estar
+// vivos na fronteira entre blocos) recebem os índices [0, boundaryCount) e
+// são os únicos que ocupam bits nos conjuntos por bloco; os demais (quase
+// todos os temporários) nascem e morrem dentro de cada bloco. Os índices
+// dos operandos de cada instrução ficam guardados, para que as análises e
+// passos não consultem a tabela de novo
+struct SymbolIndex {
+    std::unordered_map<SymbolNode*, int> index;
+    std::vector<SymbolNode*> symbols;   // Índice -> símbolo
+    std::vector<int> operands;          // 3 por instrução: definição e usos
+                                        // (na ordem de tacUses), -1 = nenhum
+    int boundaryCount;
+
+    SymbolIndex() : boundaryCount(0) {}
+
+    int size() const { return (int)symbols.size(); }
+
+    // Índice do símbolo, ou -1 se ele não é acompanhado
+    int indexOf(SymbolNode* sym) const {
+        if (!sym) return -1;
+        auto it = index.find(sym);
+        return it != index.end() ? it->second : -1;
+    }
+
+    bool crossesBlocks(int i) const { return i >= 0 && i < boundaryCount; }
+
+    // Índices do símbolo escrito e dos dois lidos pela instrução da posição
+    int definitionAt(int position) const { return operands[position * 3]; }
+    const int* usesAt(int position) const { return &operands[position * 3 + 1]; }
+};
+
+// Numera os símbolos de tracked (e os temporários, se includeTemps) que
+// aparecem na função. read conta como definição que não mata o valor
+// anterior (sem um inteiro na entrada a variável não muda)
+void numberSymbols(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                   bool includeTemps, SymbolIndex& numbering);
+
+// ==================== VIVÊNCIA ====================
+
+// Vivência por bloco: bit i de liveIn/liveOut do bloco = símbolo de índice i
+// vivo na entrada/saída (só os que cruzam blocos têm bit)
+struct Liveness {
+    SymbolIndex symbols;
+    int words;                      // Palavras por bloco
+    std::vector<uint64_t> liveIn;
+    std::vector<uint64_t> liveOut;
+
+    Liveness() : words(0) {}
+
+    int indexOf(SymbolNode* sym) const { return symbols.indexOf(sym); }
+
+    bool isLiveIn(int block, int i) const {
+        return symbols.crossesBlocks(i) && bitTest(&liveIn[block * words], i);
+    }
+
+    bool isLiveOut(int block, int i) const {
+        return symbols.crossesBlocks(i) && bitTest(&liveOut[block * words], i);
+    }
+};
+
+// Vivência (para trás, união) dos símbolos acompanhados (ver numberSymbols)
+void computeLiveness(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                     bool includeTemps, Liveness& liveness);
+
+// ==================== DEFINIÇÕES QUE ALCANÇAM ====================
+
+// Definições dos símbolos que cruzam blocos: as boundaryCount primeiras são
+// o valor de cada símbolo na entrada da função (índice da definição =
+// índice do símbolo); as seguintes são as instruções que os escrevem
+struct ReachingDefinitions {
+    SymbolIndex symbols;
+    std::vector<int> site;                  // Definição -> posição (-1 = entrada)
+    std::vector<int> symbolOf;              // Definição -> índice do símbolo
+    std::vector<std::vector<int>> ofSymbol; // Símbolo -> definições
+    int words;
+    std::vector<uint64_t> reachIn;
+    std::vector<uint64_t> reachOut;
+
+    ReachingDefinitions() : words(0) {}
+
+    bool reachesIn(int block, int d) const { return bitTest(&reachIn[block * words], d); }
+};
+
+// Definições que alcançam a entrada e a saída de cada bloco (para frente,
+// união); read gera definição sem matar as anteriores
+void computeReachingDefinitions(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                                bool includeTemps, ReachingDefinitions& reaching);
+
+// ==================== EXPRESSÕES DISPONÍVEIS ====================
+
+// Operação cujos operandos são constantes ou símbolos que cruzam blocos,
+// com o símbolo que guarda o resultado (escrito só por ela na função)
+struct Expression {
+    int type;
+    SymbolNode* op1;
+    SymbolNode* op2;
+    SymbolNode* res;
+
+    bool operator==(const Expression& other) const {
+        return type == other.type && op1 == other.op1 && op2 == other.op2 && res == other.res;
+    }
+};
+
+struct ExpressionHash {
+    size_t operator()(const Expression& e) const {
+        return std::hash<void*>()(e.op1) * 31 + std::hash<void*>()(e.op2) * 7 +
+               std::hash<void*>()(e.res) * 13 + e.type;
+    }
+};
+
+// Expressões já calculadas em todo caminho até a entrada/saída de cada
+// bloco, sem que um operando tenha mudado depois: onde uma está disponível,
+// o símbolo res tem o valor da operação
+struct AvailableExpressions {
+    SymbolIndex symbols;
+    std::vector<Expression> expressions;
+    std::unordered_map<Expression, int, ExpressionHash> index;
+    std::vector<std::vector<int>> usersOf;  // Símbolo -> expressões que o leem
+    int words;
+    std::vector<uint64_t> availableIn;
+    std::vector<uint64_t> availableOut;
+
+    AvailableExpressions() : words(0) {}
+
+    // Índice da expressão calculada pela instrução, ou -1
+    int indexOf(TAC* tac) const;
+
+    bool isAvailableIn(int block, int e) const { return bitTest(&availableIn[block * words], e); }
+};
+
+// Expressões disponíveis (para frente, interseção); só entram expressões
+// que podem atravessar blocos (operandos constantes ou que cruzam blocos) e
+// cujo resultado vai para um símbolo acompanhado com uma única definição
+void computeAvailableExpressions(const CFG& cfg, const std::unordered_set<SymbolNode*>& tracked,
+                                 bool includeTemps, AvailableExpressions& available);
+
+#endif // DATAFLOW_HPP
@@ -0,0 +1,101 @@
+/*
+ * Compiladores - etapa7 - emitter.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação do emissor de assembly em buffer
+ */
+
+#include "emitter.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Capacidade inicial do buffer
+static const size_t INITIAL_CAPACITY = 4096;
+
+AsmEmitter::AsmEmitter(bool lean) : buffer(nullptr), length(0), capacity(0), leanMode(lean) {}
+
+AsmEmitter::~AsmEmitter() {
+    free(buffer);
+}
+
+void AsmEmitter::grow(size_t needed) {
+    size_t newCapacity = capacity ? capacity : INITIAL_CAPACITY;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    char* newBuffer = static_cast<char*>(realloc(buffer, newCapacity));
+    if (!newBuffer) throw std::bad_alloc();
+    buffer = newBuffer;
+    capacity = newCapacity;
+}
+
+void AsmEmitter::put(const char* text, size_t size) {
+    reserve(size);
+    memcpy(buffer + length, text, size);
+    length += size;
+}
+
+void AsmEmitter::put(const char* text) {
+    put(text, strlen(text));
+}
+
+void AsmEmitter::putInt(long value) {
+    // Dígitos gerados do fim para o início (sem snprintf)
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    put(p, end - p);
+}
+
+void AsmEmitter::formatList(const char* format, va_list args) {
+    const char* run = format;   // Início do texto literal ainda não copiado
+    const char* p = format;
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        put(run, p - run);
+        switch (p[1]) {
+            case 's': put(va_arg(args, const char*)); break;
+            case 'd': putInt(va_arg(args, int)); break;
+            case '%': putChar('%'); break;
+            default:
+                // Conversão não suportada: erro no backend, não no programa
+                fprintf(stderr, "Erro interno: conversao nao suportada no emissor de assembly "
+                        "(formato \"%s\")\n", format);
+                abort();
+        }
+        p += p[1] ? 2 : 1;
+        run = p;
+    }
+    put(run, p - run);
+}
+
+void AsmEmitter::format(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    formatList(format, args);
+    va_end(args);
+}
+
+void AsmEmitter::note(const char* format, ...) {
+    if (leanMode) return;
+
+    va_list args;
+    va_start(args, format);
+    formatList(format, args);
+    va_end(args);
+}
+
+bool AsmEmitter::flush(FILE* output) {
+    bool ok = length == 0 || fwrite(buffer, 1, length, output) == length;
+    length = 0;
+    return ok;
+}
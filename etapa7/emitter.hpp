@@ -0,0 +1,81 @@
+/*
+ * Compiladores - etapa7 - emitter.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições do emissor de assembly: o texto é acumulado em um buffer de
+ * bytes em memória e escrito no arquivo de uma só vez, sem passar pelo
+ * fprintf (análise do formato completa e trava do stdio) a cada linha
+ */
+
+#ifndef EMITTER_HPP
+#define EMITTER_HPP
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+// Deixa o compilador conferir as chamadas de format/note contra o formato
+// (o primeiro argumento das funções membro é this)
+#if defined(__GNUC__)
+#define EMITTER_PRINTF_FORMAT   __attribute__((format(printf, 2, 3)))
+#else
+#define EMITTER_PRINTF_FORMAT
+#endif
+
+class AsmEmitter {
+private:
+    char* buffer;       // Texto acumulado (sem terminador)
+    size_t length;      // Bytes usados
+    size_t capacity;    // Bytes alocados
+    bool leanMode;      // Omite os comentários (note)
+
+    // Garante espaço para mais extra bytes
+    void reserve(size_t extra) {
+        if (length + extra > capacity) grow(length + extra);
+    }
+    void grow(size_t needed);
+
+    void formatList(const char* format, va_list args);
+
+public:
+    explicit AsmEmitter(bool lean = false);
+    ~AsmEmitter();
+
+    // Trechos de texto, caractere e inteiro em decimal
+    void put(const char* text, size_t size);
+    void put(const char* text);
+    void put(const std::string& text) { put(text.data(), text.size()); }
+    void putChar(char c) {
+        reserve(1);
+        buffer[length++] = c;
+    }
+    void putInt(long value);
+
+    // Formatação no estilo printf restrita ao que o backend usa: %s (const
+    // char*), %d (int) e %% - qualquer outra conversão aborta o programa
+    void format(const char* format, ...) EMITTER_PRINTF_FORMAT;
+
+    // Como format, mas omitido no modo enxuto: comentários do assembly
+    // (descrição de cada TAC, nomes das funções)
+    void note(const char* format, ...) EMITTER_PRINTF_FORMAT;
+
+    bool lean() const { return leanMode; }
+
+    // Acrescenta o conteúdo de outro emissor
+    void append(const AsmEmitter& other) { put(other.buffer, other.length); }
+
+    // Escreve o conteúdo em output com uma única chamada e esvazia o buffer;
+    // retorna false em caso de erro de escrita
+    bool flush(FILE* output);
+
+    const char* data() const { return buffer; }
+    size_t size() const { return length; }
+    void clear() { length = 0; }
+
+private:
+    AsmEmitter(const AsmEmitter&);
+    AsmEmitter& operator=(const AsmEmitter&);
+};
+
+#endif // EMITTER_HPP
@@ -0,0 +1,301 @@
+/*
+ * Compiladores - etapa7 - interp.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação da tradução do TAC para a forma executável: operandos
+ * viram slots densos do frame ou da memória global, vetores ganham uma
+ * faixa da área dos vetores e os labels são resolvidos para posições
+ */
+
+#include "interp.hpp"
+#include "ast.hpp"
+#include "regalloc.hpp"
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+
+// Estado da tradução do TAC para instruções
+struct InterpBuilder {
+    InterpProgram& program;
+    std::unordered_set<SymbolNode*> locals;
+    std::unordered_map<SymbolNode*, int> globalSlots;
+    std::unordered_map<SymbolNode*, int> vectorIds;
+    std::unordered_map<SymbolNode*, int> stringIds;
+    std::unordered_map<SymbolNode*, int> functionIds;
+    std::unordered_map<SymbolNode*, size_t> labels;     // Label -> posição no código
+    std::vector<std::pair<size_t, SymbolNode*>> jumps;  // Desvios a resolver
+
+    // Função sendo traduzida
+    std::unordered_map<SymbolNode*, int> frameSlots;
+    InterpFunction* function;
+
+    explicit InterpBuilder(InterpProgram& p) : program(p), function(nullptr) {}
+};
+
+// Texto de um literal string como o montador o grava (sem as aspas e com
+// as sequências de escape resolvidas; \0 encerra a string)
+static std::string unescapeString(const std::string& text) {
+    std::string result;
+    size_t end = text.size() >= 2 ? text.size() - 1 : text.size();
+    for (size_t i = 1; i < end; i++) {
+        char c = text[i];
+        if (c == '\\' && i + 1 < end) {
+            c = text[++i];
+            switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case '0': return result;
+                default: break;
+            }
+        }
+        result += c;
+    }
+    return result;
+}
+
+// Operando de valor de um símbolo (criando o slot no primeiro uso)
+static int operandOf(InterpBuilder& builder, SymbolNode* sym) {
+    if (sym && builder.function && builder.locals.count(sym)) {
+        auto it = builder.frameSlots.find(sym);
+        if (it != builder.frameSlots.end()) return it->second;
+        int slot = builder.function->frameSize++;
+        builder.frameSlots[sym] = slot;
+        return slot;
+    }
+
+    // Ausente (nullptr) vale 0, como no backend; literais não inteiros
+    // (float) também valem 0, como o .long 0 da seção de dados
+    auto it = builder.globalSlots.find(sym);
+    if (it != builder.globalSlots.end()) return ~it->second;
+    int slot = (int)builder.program.globals.size();
+    builder.program.globals.push_back(isConstant(sym) ? constantValue(sym) : 0);
+    builder.globalSlots[sym] = slot;
+    return ~slot;
+}
+
+static int vectorOf(InterpBuilder& builder, SymbolNode* sym) {
+    auto it = builder.vectorIds.find(sym);
+    if (it != builder.vectorIds.end()) return it->second;
+
+    InterpVector vector;
+    vector.base = builder.program.vectorSlots;
+    vector.length = sym->vectorSize > 0 ? sym->vectorSize : 1;
+    builder.program.vectorSlots += vector.length;
+
+    int id = (int)builder.program.vectors.size();
+    builder.program.vectors.push_back(vector);
+    builder.vectorIds[sym] = id;
+    return id;
+}
+
+static int stringOf(InterpBuilder& builder, SymbolNode* sym) {
+    auto it = builder.stringIds.find(sym);
+    if (it != builder.stringIds.end()) return it->second;
+
+    int id = (int)builder.program.strings.size();
+    builder.program.strings.push_back(unescapeString(sym->text));
+    builder.stringIds[sym] = id;
+    return id;
+}
+
+static void emit(InterpBuilder& builder, int op, int res, int op1, int op2) {
+    InterpInstr instr;
+    instr.op = op;
+    instr.res = res;
+    instr.op1 = op1;
+    instr.op2 = op2;
+    builder.program.code.push_back(instr);
+}
+
+static void emitJump(InterpBuilder& builder, int op, SymbolNode* label, int op1, int op2) {
+    builder.jumps.push_back(std::make_pair(builder.program.code.size(), label));
+    emit(builder, op, 0, op1, op2);
+}
+
+// Traduz uma instrução TAC; os casos ignorados são os mesmos do backend
+// (instruções sem os operandos obrigatórios não geram código)
+static bool translateTac(InterpBuilder& builder, TAC* tac) {
+    bool hasOperands = tac->res && tac->op1 && tac->op2;
+
+    switch (tac->type) {
+        case TAC_MOVE:
+        case TAC_NOT:
+        case TAC_NEG:
+            if (tac->res && tac->op1) {
+                emit(builder, tac->type, operandOf(builder, tac->res), operandOf(builder, tac->op1), 0);
+            }
+            break;
+
+        case TAC_ADD: case TAC_SUB: case TAC_MUL: case TAC_DIV: case TAC_MOD:
+        case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+        case TAC_AND: case TAC_OR:
+            if (hasOperands) {
+                emit(builder, tac->type, operandOf(builder, tac->res),
+                     operandOf(builder, tac->op1), operandOf(builder, tac->op2));
+            }
+            break;
+
+        case TAC_LABEL:
+            if (tac->res) builder.labels[tac->res] = builder.program.code.size();
+            break;
+
+        case TAC_JUMP:
+            if (tac->res) emitJump(builder, TAC_JUMP, tac->res, 0, 0);
+            break;
+
+        case TAC_IFZ:
+        case TAC_IFNZ:
+            if (tac->res && tac->op1) {
+                emitJump(builder, tac->type, tac->res, operandOf(builder, tac->op1), 0);
+            }
+            break;
+
+        case TAC_JLT: case TAC_JGT: case TAC_JLE: case TAC_JGE: case TAC_JEQ: case TAC_JNE:
+            if (hasOperands) {
+                emitJump(builder, tac->type, tac->res,
+                         operandOf(builder, tac->op1), operandOf(builder, tac->op2));
+            }
+            break;
+
+        case TAC_ARG:
+            if (tac->res) emit(builder, TAC_ARG, 0, operandOf(builder, tac->res), 0);
+            break;
+
+        case TAC_CALL:
+            if (tac->res && tac->op1) {
+                auto it = builder.functionIds.find(tac->op1);
+                if (it == builder.functionIds.end()) {
+                    fprintf(stderr, "Erro: função '%s' chamada mas não definida\n",
+                            tac->op1->text.c_str());
+                    return false;
+                }
+                emit(builder, TAC_CALL, operandOf(builder, tac->res), it->second, 0);
+            }
+            break;
+
+        case TAC_RET:
+            emit(builder, TAC_RET, 0, operandOf(builder, tac->op1), 0);
+            break;
+
+        case TAC_PRINT:
+            if (tac->op1 && tac->op1->type == SYMBOL_LIT_STRING) {
+                emit(builder, INTERP_PRINT_STRING, 0, stringOf(builder, tac->op1), 0);
+            } else if (tac->op1) {
+                emit(builder, TAC_PRINT, 0, operandOf(builder, tac->op1), 0);
+            }
+            break;
+
+        case TAC_READ:
+            if (tac->res) emit(builder, TAC_READ, operandOf(builder, tac->res), 0, 0);
+            break;
+
+        case TAC_VEC_ACCESS:
+            if (hasOperands) {
+                emit(builder, TAC_VEC_ACCESS, operandOf(builder, tac->res),
+                     vectorOf(builder, tac->op1), operandOf(builder, tac->op2));
+            }
+            break;
+
+        case TAC_VEC_WRITE:
+            if (hasOperands) {
+                emit(builder, TAC_VEC_WRITE, vectorOf(builder, tac->res),
+                     operandOf(builder, tac->op1), operandOf(builder, tac->op2));
+            }
+            break;
+
+        case TAC_VEC_READ:
+            if (tac->res && tac->op1) {
+                emit(builder, TAC_VEC_READ, vectorOf(builder, tac->res), operandOf(builder, tac->op1), 0);
+            }
+            break;
+
+        default:
+            // TAC_SYMBOL, TAC_BEGINFUN e TAC_ENDFUN são tratados em interpTranslate
+            break;
+    }
+    return true;
+}
+
+bool interpTranslate(TAC* tacList, InterpProgram& program) {
+    std::vector<TAC*> tacs;
+    for (TAC* t = tacList; t; t = t->prev) {
+        tacs.push_back(t);
+    }
+
+    // Inicializações globais (fora de funções) e código das funções
+    std::vector<TAC*> initTacs, funcTacs;
+    bool inFunction = false;
+    for (size_t i = tacs.size(); i-- > 0;) {
+        TAC* t = tacs[i];
+        if (t->type == TAC_BEGINFUN) inFunction = true;
+        (inFunction ? funcTacs : initTacs).push_back(t);
+        if (t->type == TAC_ENDFUN) inFunction = false;
+    }
+
+    InterpBuilder builder(program);
+    std::unordered_set<SymbolNode*> addressTaken;
+    findLocalSymbols(initTacs, funcTacs, builder.locals, addressTaken);
+
+    // Índices das funções antes da tradução (chamadas a funções adiante)
+    for (TAC* t : funcTacs) {
+        if (t->type != TAC_BEGINFUN || !t->res || builder.functionIds.count(t->res)) continue;
+        builder.functionIds[t->res] = (int)program.functions.size();
+        program.functions.push_back(InterpFunction());
+        program.functions.back().name = t->res->text;
+        if (program.mainIndex < 0 && t->res->text == "main") {
+            program.mainIndex = (int)program.functions.size() - 1;
+        }
+    }
+    if (program.mainIndex < 0) {
+        fprintf(stderr, "Erro: função main não encontrada\n");
+        return false;
+    }
+
+    // Só a primeira definição de cada função é traduzida
+    std::vector<bool> translated(program.functions.size(), false);
+    for (TAC* t : funcTacs) {
+        if (t->type == TAC_BEGINFUN) {
+            int index = t->res ? builder.functionIds[t->res] : -1;
+            builder.function = index >= 0 && !translated[index] ? &program.functions[index] : nullptr;
+            builder.frameSlots.clear();
+            if (!builder.function) continue;
+            translated[index] = true;
+
+            InterpFunction& function = *builder.function;
+            function.entry = program.code.size();
+            function.frameSize = 0;
+            std::vector<SymbolNode*> params;
+            collectParameters(t->res->parameterList, params);
+            for (SymbolNode* param : params) {
+                function.params.push_back(operandOf(builder, param));
+            }
+
+            // As inicializações globais entram na entrada do main
+            if (index == program.mainIndex) {
+                for (TAC* init : initTacs) {
+                    if (!translateTac(builder, init)) return false;
+                }
+            }
+        } else if (t->type == TAC_ENDFUN) {
+            // Fim sem return: devolve 0
+            if (builder.function) {
+                emit(builder, TAC_RET, 0, operandOf(builder, nullptr), 0);
+                builder.function->end = program.code.size();
+            }
+            builder.function = nullptr;
+        } else if (builder.function) {
+            if (!translateTac(builder, t)) return false;
+        }
+    }
+
+    for (auto& jump : builder.jumps) {
+        auto it = builder.labels.find(jump.second);
+        if (it == builder.labels.end()) {
+            fprintf(stderr, "Erro: label '%s' não encontrado\n", symbolName(jump.second).c_str());
+            return false;
+        }
+        program.code[jump.first].res = (int)it->second;
+    }
+    return true;
+}
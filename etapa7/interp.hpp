@@ -0,0 +1,70 @@
+/*
+ * Compiladores - etapa7 - interp.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições da forma executável do TAC usada pela máquina virtual: cada
+ * função vira um vetor de instruções de tamanho fixo em que os operandos já
+ * são índices densos (slot do frame ou da memória global) e os labels,
+ * posições no código. O bytecode (bytecode.hpp) grava essa forma em uma
+ * imagem contígua, que a máquina virtual (vm.hpp) executa
+ */
+
+#ifndef INTERP_HPP
+#define INTERP_HPP
+
+#include "tac.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Os códigos das instruções são os próprios tipos de TAC, mais os abaixo
+#define INTERP_PRINT_STRING 38  // print de literal string: op1 = índice da string
+#define INTERP_OPCODES      39
+
+// Instrução resolvida. Operandos de valor: >= 0 é um slot do frame da
+// ativação corrente, < 0 é o slot ~x da memória global (variáveis globais,
+// constantes e literais). Desvios guardam o destino em res, chamadas a
+// função em op1 e acessos a vetor o índice do vetor no campo do símbolo
+struct InterpInstr {
+    int op;
+    int res;
+    int op1;
+    int op2;
+};
+
+struct InterpFunction {
+    std::string name;
+    size_t entry;               // Primeira instrução
+    size_t end;                 // Instrução seguinte à última
+    int frameSize;              // Slots de locais e temporários
+    std::vector<int> params;    // Operando de cada parâmetro, em ordem
+
+    InterpFunction() : entry(0), end(0), frameSize(0) {}
+};
+
+struct InterpVector {
+    int base;                   // Primeiro slot na área dos vetores
+    int length;
+};
+
+struct InterpProgram {
+    std::vector<InterpInstr> code;
+    std::vector<InterpFunction> functions;
+    std::vector<InterpVector> vectors;
+    int vectorSlots;                    // Tamanho da área dos vetores (zerada)
+    std::vector<int32_t> globals;       // Valores iniciais da memória global
+    std::vector<std::string> strings;   // Literais string, já sem escapes
+    int mainIndex;
+
+    InterpProgram() : vectorSlots(0), mainIndex(-1) {}
+};
+
+// Traduz o programa (lista de TACs invertida, como em generateAsm). Os
+// símbolos seguem o modelo de memória do backend: locais (ver
+// findLocalSymbols) ganham um slot por ativação, os demais são globais, e
+// as inicializações globais entram na entrada do main. Retorna false (com a
+// mensagem em stderr) se o programa não tem main ou chama uma função que
+// não existe
+bool interpTranslate(TAC* tacList, InterpProgram& program);
+
+#endif // INTERP_HPP
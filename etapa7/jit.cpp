@@ -0,0 +1,656 @@
+/*
+ * Compiladores - etapa7 - jit.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação do compilador JIT para x86-64. Cada instrução do bytecode
+ * vira uma sequência fixa de instruções de máquina sobre os slots em
+ * memória (sem alocação de registradores); o código é montado em um vetor,
+ * copiado para páginas mapeadas com mmap e tornado executável (escrita e
+ * execução nunca ao mesmo tempo)
+ */
+
+#include "jit.hpp"
+#include "vm.hpp"
+#include <csetjmp>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define JIT_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool jitSupported() {
+#ifdef JIT_X86_64
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifndef JIT_X86_64
+
+bool jitRun(const BcProgram&, int&) {
+    fprintf(stderr, "ERRO DE EXECUÇÃO: JIT indisponível nesta plataforma\n");
+    return false;
+}
+
+#else
+
+// Pilha própria da execução: reservada sem páginas (o sistema só as
+// materializa quando usadas); o trecho do fundo fica para as funções da
+// biblioteca chamadas pelo código gerado, e passar do limite é recursão
+// profunda demais
+#define JIT_STACK_BYTES     ((size_t)256 << 20)
+#define JIT_STACK_RESERVE   ((size_t)1 << 20)
+
+// Frames com até tantos slots são zerados com uma escrita por slot; os
+// maiores, com rep stosd
+#define JIT_ZERO_UNROLL     8
+
+// Erros de execução detectados pelo código gerado
+#define JIT_ERROR_DIV_ZERO  0
+#define JIT_ERROR_OVERFLOW  1
+#define JIT_ERROR_BOUNDS    2
+#define JIT_ERROR_DEPTH     3
+#define JIT_ERRORS          4
+
+// Registradores (número na codificação)
+#define RAX 0
+#define RCX 1
+#define RDX 2
+#define RBP 5
+#define RSI 6
+#define RDI 7
+
+// Códigos de condição de jcc e setcc
+#define CC_B    0x2
+#define CC_AE   0x3
+#define CC_E    0x4
+#define CC_NE   0x5
+#define CC_L    0xC
+#define CC_GE   0xD
+#define CC_LE   0xE
+#define CC_G    0xF
+#define CC_JMP  -1      // Desvio incondicional
+
+// Operações de ALU (campo reg de 0x81; a forma reg, mem é 8 * op + 3)
+#define ALU_ADD 0
+#define ALU_OR  1
+#define ALU_AND 4
+#define ALU_SUB 5
+#define ALU_CMP 7
+
+// Convenção do código gerado: rbp aponta o frame da ativação (slot x em
+// [rbp - 4 (x + 1)]), r15 a memória global (slot ~x em [r15 + 4 x]), r14
+// a área dos vetores, r12 o limite da pilha e r13 guarda rsp nas chamadas
+// à biblioteca. Os argumentos são empilhados com 8 bytes cada (o primeiro
+// fica mais longe do topo), quem chama os desempilha, e o retorno vem em
+// eax; rax, rcx, rdx, rsi e rdi são livres
+
+// Operando de valor já resolvido
+struct JitOperand {
+    bool immediate;     // Constante conhecida na compilação (em value)
+    bool global;        // Base r15 em vez de rbp
+    int32_t value;      // Valor imediato ou deslocamento da base
+};
+
+struct JitCompiler {
+    const BcProgram& program;
+    std::vector<uint8_t> code;
+    std::vector<bool> constant;             // Slots globais nunca escritos
+    std::vector<uint32_t> instrOffset;      // Início de cada instrução
+    std::vector<uint32_t> functionOffset;
+    std::vector<uint32_t> functionEnd;
+    std::vector<std::pair<uint32_t, uint32_t>> jumps;   // (rel32, instrução)
+    std::vector<std::pair<uint32_t, uint32_t>> calls;   // (rel32, função)
+    std::vector<uint32_t> errors[JIT_ERRORS];           // rel32 para os tratadores da função
+    uint32_t entrySize;
+
+    explicit JitCompiler(const BcProgram& p) : program(p), entrySize(0) {}
+};
+
+// Estado da execução corrente, usado pelas funções chamadas pelo código
+// gerado (a execução é sempre na thread principal)
+static jmp_buf jitFailure;
+static int jitErrorKind;
+static int jitErrorFunction;
+
+// Endereço de entrada: troca para a pilha própria, prepara os registradores
+// fixos e chama o main
+typedef int32_t (*JitEntry)(void* stackTop, int32_t* globals, int32_t* vectors,
+                            void* stackLimit, const void* mainCode);
+
+static void jitPrintString(const char* text, int32_t length) {
+    // puts: a string e uma quebra de linha
+    fwrite(text, 1, length, stdout);
+    fputc('\n', stdout);
+}
+
+static void jitRead(int32_t* target) {
+    // Sem um inteiro na entrada a variável não muda (como no scanf)
+    int input;
+    if (scanf("%d", &input) == 1) *target = input;
+}
+
+// Não retorna: volta ao setjmp de jitRun, descartando as ativações
+static void jitFail(int kind, int function) {
+    jitErrorKind = kind;
+    jitErrorFunction = function;
+    longjmp(jitFailure, 1);
+}
+
+static void emit8(JitCompiler& jit, int byte) {
+    jit.code.push_back((uint8_t)byte);
+}
+
+static void emit32(JitCompiler& jit, uint32_t value) {
+    for (int i = 0; i < 32; i += 8) emit8(jit, value >> i);
+}
+
+static void emit64(JitCompiler& jit, uint64_t value) {
+    for (int i = 0; i < 64; i += 8) emit8(jit, (int)(value >> i));
+}
+
+static void emitBytes(JitCompiler& jit, std::initializer_list<int> bytes) {
+    for (int byte : bytes) emit8(jit, byte);
+}
+
+static void patch32(JitCompiler& jit, uint32_t at, int32_t value) {
+    memcpy(&jit.code[at], &value, sizeof(value));
+}
+
+static JitOperand operandOf(const JitCompiler& jit, int32_t x) {
+    JitOperand operand;
+    operand.immediate = x < 0 && jit.constant[~x];
+    operand.global = x < 0;
+    if (operand.immediate) {
+        operand.value = jit.program.globals[~x];
+    } else {
+        operand.value = x >= 0 ? -4 * (x + 1) : 4 * ~x;
+    }
+    return operand;
+}
+
+// Instrução com operando em memória ([rbp + disp32] ou [r15 + disp32]);
+// opcodes acima de 0xFF têm dois bytes (0x0F xx)
+static void emitMemory(JitCompiler& jit, int opcode, int reg, const JitOperand& operand,
+                       bool wide = false) {
+    int rex = (wide ? 0x48 : 0) | (operand.global ? 0x41 : 0);
+    if (rex) emit8(jit, rex);
+    if (opcode > 0xFF) emit8(jit, opcode >> 8);
+    emit8(jit, opcode & 0xFF);
+    emit8(jit, 0x80 | (reg << 3) | (operand.global ? 7 : RBP));
+    emit32(jit, operand.value);
+}
+
+static void emitLoad(JitCompiler& jit, int reg, int32_t x) {
+    JitOperand operand = operandOf(jit, x);
+    if (operand.immediate) {
+        emit8(jit, 0xB8 + reg);                             // mov reg, imm32
+        emit32(jit, operand.value);
+    } else {
+        emitMemory(jit, 0x8B, reg, operand);                // mov reg, [x]
+    }
+}
+
+// Destinos nunca são constantes (um slot escrito não é imediato)
+static void emitStore(JitCompiler& jit, int reg, int32_t x) {
+    emitMemory(jit, 0x89, reg, operandOf(jit, x));          // mov [x], reg
+}
+
+// reg = reg op x (cmp só altera as flags)
+static void emitAlu(JitCompiler& jit, int alu, int reg, int32_t x) {
+    JitOperand operand = operandOf(jit, x);
+    if (operand.immediate) {
+        emitBytes(jit, {0x81, 0xC0 | (alu << 3) | reg});    // op reg, imm32
+        emit32(jit, operand.value);
+    } else {
+        emitMemory(jit, alu * 8 + 3, reg, operand);         // op reg, [x]
+    }
+}
+
+static void emitMultiply(JitCompiler& jit, int reg, int32_t x) {
+    JitOperand operand = operandOf(jit, x);
+    if (operand.immediate) {
+        emitBytes(jit, {0x69, 0xC0 | (reg << 3) | reg});    // imul reg, reg, imm32
+        emit32(jit, operand.value);
+    } else {
+        emitMemory(jit, 0x0FAF, reg, operand);              // imul reg, [x]
+    }
+}
+
+// Desvio para a instrução target do bytecode (resolvido no fim)
+static void emitJump(JitCompiler& jit, int cc, uint32_t target) {
+    if (cc == CC_JMP) {
+        emit8(jit, 0xE9);
+    } else {
+        emitBytes(jit, {0x0F, 0x80 | cc});
+    }
+    jit.jumps.push_back(std::make_pair((uint32_t)jit.code.size(), target));
+    emit32(jit, 0);
+}
+
+// Desvio para o tratador do erro, emitido no fim da função
+static void emitError(JitCompiler& jit, int cc, int error) {
+    if (cc == CC_JMP) {
+        emit8(jit, 0xE9);
+    } else {
+        emitBytes(jit, {0x0F, 0x80 | cc});
+    }
+    jit.errors[error].push_back((uint32_t)jit.code.size());
+    emit32(jit, 0);
+}
+
+// Chamada a uma função da biblioteca: a ABI pede a pilha alinhada em 16
+// bytes, e rsp volta de r13 (preservado pela função chamada)
+static void emitHelperCall(JitCompiler& jit, uint64_t helper) {
+    emitBytes(jit, {0x49, 0x89, 0xE5});                     // mov r13, rsp
+    emitBytes(jit, {0x48, 0x83, 0xE4, 0xF0});               // and rsp, -16
+    emitBytes(jit, {0x48, 0xB8});                           // mov rax, imm64
+    emit64(jit, helper);
+    emitBytes(jit, {0xFF, 0xD0});                           // call rax
+    emitBytes(jit, {0x4C, 0x89, 0xEC});                     // mov rsp, r13
+}
+
+// Índice do vetor em eax, já verificado contra os limites
+static void emitVectorIndex(JitCompiler& jit, int32_t vector, int32_t index) {
+    const BcVector& v = jit.program.vectors[vector];
+    JitOperand operand = operandOf(jit, index);
+    if (operand.immediate && operand.value >= 0 && operand.value < v.length) {
+        emitLoad(jit, RAX, index);
+        return;
+    }
+    emitLoad(jit, RAX, index);
+    emit8(jit, 0x3D);                                       // cmp eax, length
+    emit32(jit, v.length);
+    emitError(jit, CC_AE, JIT_ERROR_BOUNDS);                // sem sinal: negativo também
+}
+
+// Endereço [r14 + rax * 4 + 4 base] do elemento (modrm com SIB)
+static void emitVectorElement(JitCompiler& jit, int opcode, int reg, int32_t vector, bool wide) {
+    emitBytes(jit, {wide ? 0x49 : 0x41, opcode, 0x84 | (reg << 3), 0x86});
+    emit32(jit, 4 * jit.program.vectors[vector].base);
+}
+
+static void emitDivision(JitCompiler& jit, const BcInstr& instr) {
+    JitOperand divisor = operandOf(jit, instr.op2);
+    emitLoad(jit, RAX, instr.op1);
+    emitLoad(jit, RCX, instr.op2);
+    // idiv gera exceção nos dois casos; com divisor constante só sobra,
+    // quando muito, um deles
+    if (!divisor.immediate) {
+        emitBytes(jit, {0x85, 0xC9});                       // test ecx, ecx
+        emitError(jit, CC_E, JIT_ERROR_DIV_ZERO);
+        emitBytes(jit, {0x83, 0xF9, 0xFF});                 // cmp ecx, -1
+        emitBytes(jit, {0x75, 0x0B});                       // jne (cmp e je abaixo)
+    } else if (divisor.value == 0) {
+        emitError(jit, CC_JMP, JIT_ERROR_DIV_ZERO);
+    }
+    if (!divisor.immediate || divisor.value == -1) {
+        emit8(jit, 0x3D);                                   // cmp eax, INT32_MIN
+        emit32(jit, 0x80000000u);
+        emitError(jit, CC_E, JIT_ERROR_OVERFLOW);
+    }
+    emit8(jit, 0x99);                                       // cdq
+    emitBytes(jit, {0xF7, 0xF9});                           // idiv ecx
+    if (instr.op == BC_MOD) {
+        emitBytes(jit, {0x89, 0xD0});                       // mov eax, edx
+    }
+    emitStore(jit, RAX, instr.res);
+}
+
+static int conditionOf(int op) {
+    switch (op) {
+        case BC_LT: case BC_JLT: return CC_L;
+        case BC_GT: case BC_JGT: return CC_G;
+        case BC_LE: case BC_JLE: return CC_LE;
+        case BC_GE: case BC_JGE: return CC_GE;
+        case BC_EQ: case BC_JEQ: return CC_E;
+        default:                 return CC_NE;
+    }
+}
+
+static void translateInstr(JitCompiler& jit, const BcInstr& instr) {
+    switch (instr.op) {
+        case BC_MOVE: {
+            JitOperand source = operandOf(jit, instr.op1);
+            if (source.immediate) {
+                emitMemory(jit, 0xC7, 0, operandOf(jit, instr.res));   // mov dword [res], imm32
+                emit32(jit, source.value);
+            } else {
+                emitLoad(jit, RAX, instr.op1);
+                emitStore(jit, RAX, instr.res);
+            }
+            break;
+        }
+
+        case BC_ADD:
+        case BC_SUB:
+        case BC_AND:
+        case BC_OR: {
+            int alu = instr.op == BC_ADD ? ALU_ADD : instr.op == BC_SUB ? ALU_SUB :
+                      instr.op == BC_AND ? ALU_AND : ALU_OR;
+            emitLoad(jit, RAX, instr.op1);
+            emitAlu(jit, alu, RAX, instr.op2);
+            emitStore(jit, RAX, instr.res);
+            break;
+        }
+
+        case BC_MUL:
+            emitLoad(jit, RAX, instr.op1);
+            emitMultiply(jit, RAX, instr.op2);
+            emitStore(jit, RAX, instr.res);
+            break;
+
+        case BC_DIV:
+        case BC_MOD:
+            emitDivision(jit, instr);
+            break;
+
+        case BC_LT:
+        case BC_GT:
+        case BC_LE:
+        case BC_GE:
+        case BC_EQ:
+        case BC_DIF:
+            emitLoad(jit, RAX, instr.op1);
+            emitAlu(jit, ALU_CMP, RAX, instr.op2);
+            emitBytes(jit, {0x0F, 0x90 | conditionOf(instr.op), 0xC0});    // setcc al
+            emitBytes(jit, {0x0F, 0xB6, 0xC0});                             // movzx eax, al
+            emitStore(jit, RAX, instr.res);
+            break;
+
+        case BC_NOT:
+            emitLoad(jit, RAX, instr.op1);
+            emitBytes(jit, {0x85, 0xC0});                   // test eax, eax
+            emitBytes(jit, {0x0F, 0x94, 0xC0});             // sete al
+            emitBytes(jit, {0x0F, 0xB6, 0xC0});             // movzx eax, al
+            emitStore(jit, RAX, instr.res);
+            break;
+
+        case BC_NEG:
+            emitLoad(jit, RAX, instr.op1);
+            emitBytes(jit, {0xF7, 0xD8});                   // neg eax
+            emitStore(jit, RAX, instr.res);
+            break;
+
+        case BC_JUMP:
+            emitJump(jit, CC_JMP, instr.res);
+            break;
+
+        case BC_IFZ:
+        case BC_IFNZ: {
+            JitOperand condition = operandOf(jit, instr.op1);
+            bool zero = instr.op == BC_IFZ;
+            if (condition.immediate) {
+                // Decidido na compilação
+                if ((condition.value == 0) == zero) emitJump(jit, CC_JMP, instr.res);
+            } else {
+                emitMemory(jit, 0x83, ALU_CMP, condition);  // cmp dword [op1], 0
+                emit8(jit, 0);
+                emitJump(jit, zero ? CC_E : CC_NE, instr.res);
+            }
+            break;
+        }
+
+        case BC_JLT:
+        case BC_JGT:
+        case BC_JLE:
+        case BC_JGE:
+        case BC_JEQ:
+        case BC_JNE:
+            emitLoad(jit, RAX, instr.op1);
+            emitAlu(jit, ALU_CMP, RAX, instr.op2);
+            emitJump(jit, conditionOf(instr.op), instr.res);
+            break;
+
+        case BC_ARG:
+            emitLoad(jit, RAX, instr.op1);
+            emit8(jit, 0x50);                               // push rax
+            break;
+
+        case BC_CALL: {
+            const BcFunction& callee = jit.program.functions[instr.op1];
+            emit8(jit, 0xE8);                               // call rel32
+            jit.calls.push_back(std::make_pair((uint32_t)jit.code.size(), (uint32_t)instr.op1));
+            emit32(jit, 0);
+            if (callee.paramCount > 0) {
+                emitBytes(jit, {0x48, 0x81, 0xC4});         // add rsp, 8 * parâmetros
+                emit32(jit, 8 * callee.paramCount);
+            }
+            emitStore(jit, RAX, instr.res);
+            break;
+        }
+
+        case BC_RET:
+            emitLoad(jit, RAX, instr.op1);
+            emitBytes(jit, {0xC9, 0xC3});                   // leave; ret
+            break;
+
+        case BC_PRINT:
+            emitLoad(jit, RDI, instr.op1);
+            emitHelperCall(jit, (uint64_t)(uintptr_t)&vmPrintInt);
+            break;
+
+        case BC_PRINT_STRING:
+            emitBytes(jit, {0x48, 0xBF});                   // mov rdi, imm64
+            emit64(jit, (uint64_t)(uintptr_t)(jit.program.text + instr.op1));
+            emit8(jit, 0xB8 + RSI);                         // mov esi, imm32
+            emit32(jit, instr.op2);
+            emitHelperCall(jit, (uint64_t)(uintptr_t)&jitPrintString);
+            break;
+
+        case BC_READ:
+            emitMemory(jit, 0x8D, RDI, operandOf(jit, instr.res), true);   // lea rdi, [res]
+            emitHelperCall(jit, (uint64_t)(uintptr_t)&jitRead);
+            break;
+
+        case BC_VEC_ACCESS:
+            emitVectorIndex(jit, instr.op1, instr.op2);
+            emitVectorElement(jit, 0x8B, RAX, instr.op1, false);           // mov eax, [elemento]
+            emitStore(jit, RAX, instr.res);
+            break;
+
+        case BC_VEC_WRITE:
+            emitVectorIndex(jit, instr.res, instr.op1);
+            emitLoad(jit, RCX, instr.op2);
+            emitVectorElement(jit, 0x89, RCX, instr.res, false);           // mov [elemento], ecx
+            break;
+
+        case BC_VEC_READ:
+            emitVectorIndex(jit, instr.res, instr.op1);
+            emitVectorElement(jit, 0x8D, RDI, instr.res, true);            // lea rdi, [elemento]
+            emitHelperCall(jit, (uint64_t)(uintptr_t)&jitRead);
+            break;
+    }
+}
+
+// Entrada: salva os registradores preservados pela ABI, troca de pilha
+// (o rsp antigo fica no topo da nova) e chama o main
+static void emitEntry(JitCompiler& jit) {
+    emitBytes(jit, {0x55, 0x41, 0x54, 0x41, 0x55,           // push rbp, r12, r13,
+                    0x41, 0x56, 0x41, 0x57});               //      r14, r15
+    emitBytes(jit, {0x48, 0x89, 0xE0});                     // mov rax, rsp
+    emitBytes(jit, {0x48, 0x89, 0xFC});                     // mov rsp, rdi
+    emit8(jit, 0x50);                                       // push rax
+    emitBytes(jit, {0x48, 0x83, 0xEC, 0x08});               // sub rsp, 8 (alinhamento)
+    emitBytes(jit, {0x49, 0x89, 0xF7});                     // mov r15, rsi
+    emitBytes(jit, {0x49, 0x89, 0xD6});                     // mov r14, rdx
+    emitBytes(jit, {0x49, 0x89, 0xCC});                     // mov r12, rcx
+    emitBytes(jit, {0x41, 0xFF, 0xD0});                     // call r8
+    emitBytes(jit, {0x48, 0x83, 0xC4, 0x08});               // add rsp, 8
+    emit8(jit, 0x5C);                                       // pop rsp
+    emitBytes(jit, {0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D,     // pop r15, r14, r13,
+                    0x41, 0x5C, 0x5D, 0xC3});               //     r12, rbp; ret
+}
+
+// Prólogo: frame zerado (como na máquina virtual), verificação do limite
+// da pilha e cópia dos argumentos para os slots dos parâmetros
+static void emitPrologue(JitCompiler& jit, const BcFunction& function) {
+    emitBytes(jit, {0x55, 0x48, 0x89, 0xE5});               // push rbp; mov rbp, rsp
+    uint32_t frameBytes = (function.frameSize * 4 + 15) & ~15u;
+    if (frameBytes > 0) {
+        emitBytes(jit, {0x48, 0x81, 0xEC});                 // sub rsp, frameBytes
+        emit32(jit, frameBytes);
+    }
+    emitBytes(jit, {0x4C, 0x39, 0xE4});                     // cmp rsp, r12
+    emitError(jit, CC_B, JIT_ERROR_DEPTH);
+
+    JitOperand slot;
+    slot.immediate = false;
+    slot.global = false;
+    if (function.frameSize <= JIT_ZERO_UNROLL) {
+        for (uint32_t i = 0; i < function.frameSize; i++) {
+            slot.value = -4 * (int32_t)(i + 1);
+            emitMemory(jit, 0xC7, 0, slot);                 // mov dword [slot], 0
+            emit32(jit, 0);
+        }
+    } else {
+        slot.value = -4 * (int32_t)function.frameSize;
+        emitMemory(jit, 0x8D, RDI, slot, true);             // lea rdi, [primeiro slot]
+        emitBytes(jit, {0x31, 0xC0});                       // xor eax, eax
+        emit8(jit, 0xB8 + RCX);                             // mov ecx, frameSize
+        emit32(jit, function.frameSize);
+        emitBytes(jit, {0xF3, 0xAB});                       // rep stosd
+    }
+
+    // O argumento i está em [rbp + 16 + 8 (n - 1 - i)]
+    const int32_t* params = jit.program.params + function.firstParam;
+    for (uint32_t i = 0; i < function.paramCount; i++) {
+        slot.value = 16 + 8 * (int32_t)(function.paramCount - 1 - i);
+        emitMemory(jit, 0x8B, RAX, slot);
+        emitStore(jit, RAX, params[i]);
+    }
+}
+
+// Tratadores dos erros usados pela função: chamam jitFail, que não volta
+static void emitErrorHandlers(JitCompiler& jit, int function) {
+    for (int kind = 0; kind < JIT_ERRORS; kind++) {
+        if (jit.errors[kind].empty()) continue;
+        int32_t here = (int32_t)jit.code.size();
+        for (uint32_t at : jit.errors[kind]) {
+            patch32(jit, at, here - (int32_t)(at + 4));
+        }
+        jit.errors[kind].clear();
+        emit8(jit, 0xB8 + RDI);                             // mov edi, kind
+        emit32(jit, kind);
+        emit8(jit, 0xB8 + RSI);                             // mov esi, function
+        emit32(jit, function);
+        emitBytes(jit, {0x48, 0x83, 0xE4, 0xF0});           // and rsp, -16
+        emitBytes(jit, {0x48, 0xB8});                       // mov rax, imm64
+        emit64(jit, (uint64_t)(uintptr_t)&jitFail);
+        emitBytes(jit, {0xFF, 0xD0});                       // call rax
+    }
+}
+
+static void jitCompile(JitCompiler& jit) {
+    const BcProgram& program = jit.program;
+    const BcHeader* header = program.header;
+
+    // Slots globais que nenhuma instrução escreve (constantes, literais e
+    // variáveis nunca alteradas) viram imediatos
+    jit.constant.assign(header->globalCount, true);
+    for (uint32_t i = 0; i < header->codeCount; i++) {
+        const BcInstr& instr = program.code[i];
+        bool writes = instr.op <= BC_NEG || instr.op == BC_CALL || instr.op == BC_READ ||
+                      instr.op == BC_VEC_ACCESS;
+        if (writes && instr.res < 0) jit.constant[~instr.res] = false;
+    }
+    for (uint32_t i = 0; i < header->paramCount; i++) {
+        if (program.params[i] < 0) jit.constant[~program.params[i]] = false;
+    }
+
+    emitEntry(jit);
+    jit.entrySize = (uint32_t)jit.code.size();
+
+    jit.instrOffset.resize(header->codeCount);
+    for (uint32_t f = 0; f < header->functionCount; f++) {
+        const BcFunction& function = program.functions[f];
+        jit.functionOffset.push_back((uint32_t)jit.code.size());
+        emitPrologue(jit, function);
+        for (uint32_t i = function.entry; i < function.end; i++) {
+            jit.instrOffset[i] = (uint32_t)jit.code.size();
+            translateInstr(jit, program.code[i]);
+        }
+        emitErrorHandlers(jit, (int)f);
+        jit.functionEnd.push_back((uint32_t)jit.code.size());
+    }
+
+    for (const auto& jump : jit.jumps) {
+        patch32(jit, jump.first, (int32_t)jit.instrOffset[jump.second] - (int32_t)(jump.first + 4));
+    }
+    for (const auto& call : jit.calls) {
+        patch32(jit, call.first, (int32_t)jit.functionOffset[call.second] - (int32_t)(call.first + 4));
+    }
+}
+
+// Mapa de símbolos do perf (uma linha "início tamanho nome" por função);
+// sem o arquivo só se perde a atribuição das amostras
+static void writePerfMap(const JitCompiler& jit, const uint8_t* code) {
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "/tmp/perf-%ld.map", (long)getpid());
+    FILE* file = fopen(fileName, "w");
+    if (!file) return;
+    fprintf(file, "%lx %lx jit_entry\n", (unsigned long)(uintptr_t)code, (unsigned long)jit.entrySize);
+    for (size_t f = 0; f < jit.functionOffset.size(); f++) {
+        fprintf(file, "%lx %lx %s\n", (unsigned long)(uintptr_t)(code + jit.functionOffset[f]),
+                (unsigned long)(jit.functionEnd[f] - jit.functionOffset[f]),
+                jit.program.text + jit.program.functions[f].name);
+    }
+    fclose(file);
+}
+
+bool jitRun(const BcProgram& program, int& result) {
+    JitCompiler jit(program);
+    jitCompile(jit);
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t codeBytes = (jit.code.size() + page - 1) / page * page;
+    void* codeArea = mmap(nullptr, codeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void* stackArea = mmap(nullptr, JIT_STACK_BYTES, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    int32_t* vectors = static_cast<int32_t*>(calloc(program.header->vectorSlots + 1, sizeof(int32_t)));
+    bool ready = codeArea != MAP_FAILED && stackArea != MAP_FAILED && vectors;
+    if (ready) {
+        memcpy(codeArea, jit.code.data(), jit.code.size());
+        ready = mprotect(codeArea, codeBytes, PROT_READ | PROT_EXEC) == 0;
+    }
+
+    bool ok = false;
+    if (!ready) {
+        fprintf(stderr, "ERRO DE EXECUÇÃO: memória insuficiente para o código gerado\n");
+    } else {
+        const uint8_t* code = static_cast<const uint8_t*>(codeArea);
+        uint8_t* stack = static_cast<uint8_t*>(stackArea);
+        writePerfMap(jit, code);
+
+        if (setjmp(jitFailure) == 0) {
+            JitEntry entry = reinterpret_cast<JitEntry>(codeArea);
+            result = entry(stack + JIT_STACK_BYTES, program.globals, vectors, stack + JIT_STACK_RESERVE,
+                           code + jit.functionOffset[program.header->mainIndex]);
+            ok = true;
+        } else {
+            static const char* messages[JIT_ERRORS] = {
+                "divisão por zero", "estouro na divisão",
+                "índice fora dos limites do vetor", "recursão profunda demais"
+            };
+            fflush(stdout);
+            fprintf(stderr, "ERRO DE EXECUÇÃO: %s (função %s)\n", messages[jitErrorKind],
+                    program.text + program.functions[jitErrorFunction].name);
+        }
+    }
+
+    if (codeArea != MAP_FAILED) munmap(codeArea, codeBytes);
+    if (stackArea != MAP_FAILED) munmap(stackArea, JIT_STACK_BYTES);
+    free(vectors);
+    return ok;
+}
+
+#endif // JIT_X86_64
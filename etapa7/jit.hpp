@@ -0,0 +1,26 @@
+/*
+ * Compiladores - etapa7 - jit.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições do compilador JIT: o bytecode (bytecode.hpp) de cada função
+ * vira código de máquina x86-64 em um buffer executável (mmap), que roda
+ * no próprio processo, sem assembler, ligador nem processo filho
+ */
+
+#ifndef JIT_HPP
+#define JIT_HPP
+
+#include "bytecode.hpp"
+
+// O JIT só gera código para x86-64 (System V); nas demais plataformas o
+// programa deve rodar na máquina virtual
+bool jitSupported();
+
+// Compila e executa o programa a partir do main, com a mesma semântica de
+// vmRun (saída em stdout, entrada de stdin, erros de execução reportados
+// em stderr e devolvidos como false). Os endereços e nomes das funções
+// geradas são gravados em /tmp/perf-<pid>.map, para que o perf atribua
+// as amostras às funções do programa
+bool jitRun(const BcProgram& program, int& result);
+
+#endif // JIT_HPP
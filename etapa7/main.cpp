@@ -9,8 +9,17 @@
 #include "semantic.hpp"
 #include "tac.hpp"
 #include "asm.hpp"
+#include "timing.hpp"
+#include "stream.hpp"
+#include "threadpool.hpp"
+#include "bytecode.hpp"
+#include "vm.hpp"
+#include "jit.hpp"
+#include "optimizer.hpp"
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -23,27 +32,220 @@ extern ASTNode* programRoot;
 // Contador de erros sintaticos (definido no parser.y)
 extern int syntaxErrorCount;
 
+static void printUsage(const char* program) {
+  cerr << "Uso: " << program << " [opcoes] <arquivo_entrada> <arquivo_saida>" << endl;
+  cerr << "     " << program << " --interp [opcoes] <arquivo_entrada>" << endl;
+  cerr << "     " << program << " --run [opcoes] <arquivo_entrada>" << endl;
+  cerr << "     " << program << " --exec <arquivo_bytecode>" << endl;
+  cerr << "Opcoes:" << endl;
+  cerr << "  --target=arm64    gera assembly ARM64 para macOS (padrao)" << endl;
+  cerr << "  --target=x86-64   gera assembly x86-64 para Linux (System V)" << endl;
+  cerr << "  --stream          compila cada declaracao assim que analisada (memoria limitada;" << endl;
+  cerr << "                    nao imprime a tabela de simbolos, a AST nem o TAC)" << endl;
+  cerr << "  -O0, -O1, -O2     nivel de otimizacao do TAC (padrao: -O0, nenhuma); -O1 limpa" << endl;
+  cerr << "                    desvios, propaga constantes e copias e remove codigo morto," << endl;
+  cerr << "                    -O2 tambem tira invariantes dos lacos, reaproveita subexpressoes" << endl;
+  cerr << "                    comuns e repete ate estabilizar" << endl;
+  cerr << "  --lean-asm        omite os comentarios do assembly (descricao de cada TAC)" << endl;
+  cerr << "  --jobs=<n>        threads que traduzem, otimizam e geram o assembly das funcoes" << endl;
+  cerr << "                    (padrao: numero de nucleos)" << endl;
+  cerr << "  --bytecode        grava o bytecode da maquina virtual em vez do assembly" << endl;
+  cerr << "  --interp          executa o programa na maquina virtual, sem gerar assembly" << endl;
+  cerr << "                    (a saida padrao fica so com a saida do programa)" << endl;
+  cerr << "  --run             compila o programa para codigo de maquina x86-64 na memoria" << endl;
+  cerr << "                    e o executa (JIT; grava /tmp/perf-<pid>.map para o perf)" << endl;
+  cerr << "  --exec            executa um arquivo gravado com --bytecode" << endl;
+  cerr << "  --time-report     imprime tempo, memoria e alocacoes de cada fase (e de cada" << endl;
+  cerr << "                    passo de otimizacao)" << endl;
+  cerr << "  --trace=<arquivo> grava as fases em JSON (trace-event, chrome://tracing)" << endl;
+}
+
+// Executa um programa gravado com --bytecode: a imagem e mapeada do arquivo
+// e executada sem analise nem traducao
+static int executeBytecode(const char* fileName) {
+  BcMapping mapping;
+  BcProgram program;
+  if (!bytecodeMap(fileName, mapping)) {
+    cerr << "Erro: nao foi possivel abrir o arquivo de bytecode " << fileName << endl;
+    return 2;
+  }
+  if (!bytecodeLoad(mapping.data, mapping.size, program)) {
+    cerr << "Erro: " << fileName << " nao contem bytecode valido" << endl;
+    bytecodeUnmap(mapping);
+    return 2;
+  }
+
+  int value = 0;
+  bool ok;
+  {
+    PhaseTimer phase("execucao do bytecode");
+    ok = vmRun(program, value);
+  }
+  fflush(stdout);
+  bytecodeUnmap(mapping);
+  return ok ? value : 5;
+}
+
+// Compilacao em fluxo: as declaracoes sao analisadas, traduzidas e emitidas
+// durante a analise sintatica (ver stream.hpp)
+static int compileStreaming(const char* outputName, int target, bool lean, int optLevel,
+                            bool passReport) {
+  FILE* outputFile = fopen(outputName, "w");
+  if (!outputFile) {
+    cerr << "Erro: nao foi possivel abrir o arquivo de saida " << outputName << endl;
+    fclose(yyin);
+    finalizeSymbolTable();
+    return 4;
+  }
+
+  cout << "Gerando codigo assembly em fluxo em: " << outputName << endl;
+  streamBegin(outputFile, target, lean, optLevel);
+
+  int result;
+  {
+    PhaseTimer phase("compilacao em fluxo");
+    result = yyparse();
+  }
+  fclose(yyin);
+
+  int semanticErrors;
+  {
+    PhaseTimer phase("funcoes adiadas");
+    semanticErrors = streamEnd();
+  }
+  if (passReport && optLevel > OPT_LEVEL_NONE) {
+    optimizerPrintReport(stderr);
+  }
+  fclose(outputFile);
+
+  int status = 0;
+  if (syntaxErrorCount > 0 || result != 0) {
+    cerr << "\nAnalise sintatica concluida com " << syntaxErrorCount << " erro(s) sintatico(s)" << endl;
+    cerr << "Geracao de codigo DESABILITADA devido a erros sintaticos" << endl;
+    status = 3;
+  } else if (semanticErrors > 0) {
+    cerr << "Compilacao FALHOU devido a erros semanticos" << endl;
+    status = 4;
+  }
+
+  {
+    PhaseTimer phase("liberacao de memoria");
+    freeAST();
+    finalizeSymbolTable();
+  }
+
+  // Com erros o assembly ficou incompleto
+  if (status != 0) {
+    remove(outputName);
+    exit(status);
+  }
+
+  cout << "\nCompilacao concluida com SUCESSO!" << endl;
+  cout << "\nPara montar e executar o codigo gerado:" << endl;
+  cout << "  gcc -o programa " << outputName << endl;
+  cout << "  ./programa" << endl;
+  exit(0);
+}
+
 int main(int argc, char *argv[]) {
-  // Verifica se foram passados dois arquivos como parametros
-  if (argc != 3) {
-    cerr << "Uso: " << argv[0] << " <arquivo_entrada> <arquivo_saida>" << endl;
+  // Separa opcoes dos arquivos de entrada e saida
+  int target = ASM_TARGET_ARM64;
+  const char* inputName = nullptr;
+  const char* outputName = nullptr;
+  bool timeReport = false;
+  const char* traceFile = nullptr;
+  bool stream = false;
+  int jobs = defaultThreadCount();
+  bool lean = false;
+  int optLevel = OPT_LEVEL_NONE;
+  bool interpret = false;
+  bool jit = false;
+  bool bytecode = false;
+  bool execute = false;
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (arg == "--target=arm64") {
+      target = ASM_TARGET_ARM64;
+    } else if (arg == "--target=x86-64") {
+      target = ASM_TARGET_X86_64;
+    } else if (arg == "--stream") {
+      stream = true;
+    } else if (arg == "--interp") {
+      interpret = true;
+    } else if (arg == "--run") {
+      interpret = true;
+      jit = true;
+    } else if (arg == "--bytecode") {
+      bytecode = true;
+    } else if (arg == "--exec") {
+      execute = true;
+    } else if (arg == "-O0" || arg == "-O1" || arg == "-O2") {
+      optLevel = arg[2] - '0';
+    } else if (arg == "--lean-asm") {
+      lean = true;
+    } else if (arg.compare(0, 7, "--jobs=") == 0 && atoi(argv[i] + 7) > 0) {
+      jobs = atoi(argv[i] + 7);
+    } else if (arg == "--time-report") {
+      timeReport = true;
+    } else if (arg.compare(0, 8, "--trace=") == 0 && arg.size() > 8) {
+      traceFile = argv[i] + 8;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      cerr << "Erro: opcao desconhecida " << arg << endl;
+      printUsage(argv[0]);
+      return 1;
+    } else if (!inputName) {
+      inputName = argv[i];
+    } else if (!outputName) {
+      outputName = argv[i];
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  // Verifica se foram passados dois arquivos como parametros (so a entrada
+  // com --interp, --run e --exec, que nao combinam com a compilacao em fluxo)
+  bool run = interpret || execute;
+  if (!inputName || (!outputName && !run) || (outputName && run) ||
+      (stream && (run || bytecode)) || (interpret && execute)) {
+    printUsage(argv[0]);
     return 1;
   }
 
+  // Mede as fases se pedido (relatorio e trace sao emitidos na saida do programa)
+  if (timeReport || traceFile) {
+    timingEnable(timeReport, traceFile);
+  }
+
+  if (execute) {
+    exit(executeBytecode(inputName));
+  }
+
   // Tenta abrir o arquivo de entrada
-  yyin = fopen(argv[1], "r");
+  yyin = fopen(inputName, "r");
   if (!yyin) {
-    cerr << "Erro: nao foi possivel abrir o arquivo de entrada " << argv[1] << endl;
+    cerr << "Erro: nao foi possivel abrir o arquivo de entrada " << inputName << endl;
     return 2;
   }
 
-  cout << "Iniciando analise sintatica do arquivo: " << argv[1] << endl;
+  if (!interpret) {
+    cout << "Iniciando analise sintatica do arquivo: " << inputName << endl;
+  }
 
   // Inicializa o analisador lexico e a tabela de simbolos
   initMe();
 
+  if (stream) {
+    return compileStreaming(outputName, target, lean, optLevel, timeReport);
+  }
+
   // Executa a analise sintatica (com recuperacao de erros)
-  int result = yyparse();
+  int result;
+  {
+    PhaseTimer phase("analise lexica e sintatica");
+    result = yyparse();
+  }
 
   // Fecha o arquivo
   fclose(yyin);
@@ -64,7 +266,7 @@ int main(int argc, char *argv[]) {
       // Imprime a AST (parcial)
       printAST(programRoot);
 
-      freeAST(programRoot);
+      freeAST();
     }
 
     finalizeSymbolTable();
@@ -72,67 +274,154 @@ int main(int argc, char *argv[]) {
   }
 
   // Se a analise foi bem-sucedida (sem erros sintaticos)
-  cout << "Analise sintatica concluida com SUCESSO!" << endl;
+  if (!interpret) {
+    cout << "Analise sintatica concluida com SUCESSO!" << endl;
+  }
 
   // Executa analise semantica
   SemanticAnalyzer semantic;
-  bool semanticSuccess = semantic.analyze(programRoot);
-
-  // Imprime a tabela de simbolos
-  symbolTable->printTable();
+  bool semanticSuccess;
+  {
+    PhaseTimer phase("analise semantica");
+    semanticSuccess = semantic.analyze(programRoot, !interpret);
+  }
 
-  // Imprime a AST
-  printAST(programRoot);
+  // Imprime a tabela de simbolos e a AST
+  if (!interpret) {
+    PhaseTimer phase("impressao da tabela e da AST");
+    symbolTable->printTable();
+    printAST(programRoot);
+  }
 
   // Se houve erros semanticos, termina com exit(4)
   if (!semanticSuccess) {
     cerr << "Compilacao FALHOU devido a erros semanticos" << endl;
-    if (programRoot) freeAST(programRoot);
+    freeAST();
     finalizeSymbolTable();
     exit(4);
   }
 
   // Gera codigo TAC (Three Address Code)
-  cout << "\nGerando codigo intermediario (TAC)..." << endl;
-  TAC* tacCode = generateTAC(programRoot);
+  if (!interpret) {
+    cout << "\nGerando codigo intermediario (TAC)..." << endl;
+  }
+  // As funcoes sao traduzidas, otimizadas e (no assembly) geradas em
+  // paralelo no mesmo pool
+  ThreadPool pool(jobs);
+  TACCode tacCode;
+  {
+    PhaseTimer phase("geracao de TAC");
+    tacCode = generateProgramTAC(programRoot, pool);
+  }
 
-  if (tacCode) {
-    // A lista esta invertida, usar tacPrintBackwards para reverter e imprimir
-    tacPrintBackwards(tacCode);
+  // Otimiza o TAC de cada funcao no nivel pedido (-O1/-O2)
+  if (optLevel > OPT_LEVEL_NONE) {
+    {
+      PhaseTimer phase("otimizacao do TAC");
+      optimizeProgram(tacCode.first, optLevel, pool);
+    }
+    if (timeReport) {
+      optimizerPrintReport(stderr);
+    }
+  }
+
+  // Executa o programa na maquina virtual (ou no JIT, com --run) em vez de
+  // gerar assembly; o codigo de saida e o valor devolvido por main (5 em
+  // erro de execucao)
+  if (interpret) {
+    std::vector<char> image;
+    BcProgram program;
+    int value = 0;
+    bool ok;
+    {
+      PhaseTimer phase("geracao de bytecode");
+      ok = bytecodeCompile(tacCode.last, image) &&
+           bytecodeLoad(image.data(), image.size(), program);
+    }
+    if (ok && jit && !jitSupported()) {
+      cerr << "Aviso: JIT indisponivel nesta plataforma, executando na maquina virtual" << endl;
+      jit = false;
+    }
+    if (ok && jit) {
+      PhaseTimer phase("compilacao JIT e execucao");
+      ok = jitRun(program, value);
+    } else if (ok) {
+      PhaseTimer phase("execucao do bytecode");
+      ok = vmRun(program, value);
+    }
+    fflush(stdout);
+
+    {
+      PhaseTimer phase("liberacao de memoria");
+      tacFree(tacCode.first);
+      freeAST();
+      finalizeSymbolTable();
+    }
+    exit(ok ? value : 5);
+  }
+
+  if (!tacCode.empty()) {
+    PhaseTimer phase("impressao do TAC");
+    tacPrintForward(tacCode.first);
+  }
+
+  // Grava o bytecode da maquina virtual em vez do assembly
+  if (bytecode) {
+    std::vector<char> image;
+    bool ok;
+    {
+      PhaseTimer phase("geracao de bytecode");
+      ok = bytecodeCompile(tacCode.last, image);
+    }
+    if (ok && !bytecodeSave(image, outputName)) {
+      cerr << "Erro: nao foi possivel gravar o arquivo de saida " << outputName << endl;
+      ok = false;
+    }
+
+    if (ok) {
+      cout << "Bytecode gravado em: " << outputName << endl;
+      cout << "\nPara executar o bytecode gerado:" << endl;
+      cout << "  " << argv[0] << " --exec " << outputName << endl;
+    }
+
+    {
+      PhaseTimer phase("liberacao de memoria");
+      tacFree(tacCode.first);
+      freeAST();
+      finalizeSymbolTable();
+    }
+    exit(ok ? 0 : 4);
   }
 
   // Abre arquivo de saida para geracao de codigo assembly
-  FILE* outputFile = fopen(argv[2], "w");
+  FILE* outputFile = fopen(outputName, "w");
   if (!outputFile) {
-    cerr << "Erro: nao foi possivel abrir o arquivo de saida " << argv[2] << endl;
+    cerr << "Erro: nao foi possivel abrir o arquivo de saida " << outputName << endl;
     finalizeSymbolTable();
-    if (programRoot) freeAST(programRoot);
+    freeAST();
     return 4;
   }
 
   // Gera o codigo assembly
-  cout << "Gerando codigo assembly em: " << argv[2] << endl;
-  generateAsm(tacCode, outputFile);
-  fclose(outputFile);
+  cout << "Gerando codigo assembly em: " << outputName << endl;
+  {
+    PhaseTimer phase("geracao de assembly");
+    generateAsm(tacCode.last, outputFile, target, pool, lean);
+    fclose(outputFile);
+  }
 
   cout << "\nCompilacao concluida com SUCESSO!" << endl;
   cout << "\nPara montar e executar o codigo gerado:" << endl;
-  cout << "  gcc -o programa " << argv[2] << endl;
+  cout << "  gcc -o programa " << outputName << endl;
   cout << "  ./programa" << endl;
 
-  // Libera memoria do TAC
-  if (tacCode) {
-    TAC* current = tacCode;
-    while (current) {
-      TAC* temp = current->prev;
-      delete current;
-      current = temp;
-    }
+  // Libera memoria do TAC, da AST e da tabela de simbolos
+  {
+    PhaseTimer phase("liberacao de memoria");
+    tacFree(tacCode.first);
+    freeAST();
+    finalizeSymbolTable();
   }
 
-  // Libera memoria
-  if (programRoot) freeAST(programRoot);
-  finalizeSymbolTable();
-
   exit(0);
 }
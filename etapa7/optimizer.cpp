@@ -0,0 +1,240 @@
+/*
+ * Compiladores - etapa7 - optimizer.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Gerenciador de passos: roda a sequência do nível em cada função, mede
+ * cada passo e invalida as análises guardadas sempre que um passo informa
+ * alguma mudança
+ */
+
+#include "optimizer.hpp"
+#include "passes.hpp"
+#include "regalloc.hpp"
+#include "threadpool.hpp"
+#include <atomic>
+#include <chrono>
+
+// Rodadas de -O2: a sequência se repete enquanto algum passo muda o código
+#define OPT_MAX_ROUNDS      4
+
+struct OptPass {
+    const char* name;
+    int (*run)(OptFunction& function);
+};
+
+static const OptPass passList[] = {
+    {"desvios", passSimplifyJumps},
+    {"propagacao", passPropagate},
+    {"invariantes", passHoistInvariants},
+    {"subexpressoes", passEliminateCommonExpressions},
+    {"codigo-morto", passDeadCode},
+};
+
+#define PASS_JUMPS          0
+#define PASS_PROPAGATE      1
+#define PASS_INVARIANTS     2
+#define PASS_COMMON         3
+#define PASS_DEAD_CODE      4
+#define PASS_COUNT          5
+
+// Sequência de cada nível (índices em passList, -1 encerra)
+static const int basicPipeline[] = {
+    PASS_JUMPS, PASS_PROPAGATE, PASS_DEAD_CODE, PASS_JUMPS, -1
+};
+static const int fullPipeline[] = {
+    PASS_JUMPS, PASS_PROPAGATE, PASS_INVARIANTS, PASS_COMMON, PASS_PROPAGATE, PASS_DEAD_CODE,
+    PASS_JUMPS, -1
+};
+
+// Estatísticas acumuladas (para optimizerPrintReport); as funções são
+// otimizadas em paralelo, então os contadores são atômicos
+struct PassStats {
+    std::atomic<unsigned long> runs;
+    std::atomic<unsigned long> changes;
+    std::atomic<unsigned long> nanoseconds;
+};
+
+#define ANALYSIS_CFG        0
+#define ANALYSIS_LIVENESS   1
+#define ANALYSIS_DOMINATORS 2
+#define ANALYSIS_REACHING   3
+#define ANALYSIS_AVAILABLE  4
+#define ANALYSIS_COUNT      5
+
+static const char* analysisNames[ANALYSIS_COUNT] = {
+    "cfg", "vivencia", "dominadores", "definicoes", "expressoes"
+};
+
+static PassStats passStats[PASS_COUNT];
+static std::atomic<unsigned long> analysisComputed[ANALYSIS_COUNT];
+static std::atomic<unsigned long> analysisReused[ANALYSIS_COUNT];
+static std::atomic<unsigned long> functionsOptimized(0);
+static std::atomic<int> reportLevel(OPT_LEVEL_NONE);
+
+// ==================== ANÁLISES ====================
+
+OptFunction::OptFunction(TAC* begin, const std::unordered_set<SymbolNode*>& localSymbols)
+    : beginFun(begin), locals(localSymbols),
+      cfgValid(false), livenessValid(false), dominatorsValid(false), reachingValid(false),
+      availableValid(false) {}
+
+const CFG& OptFunction::cfg() {
+    if (cfgValid) {
+        analysisReused[ANALYSIS_CFG]++;
+    } else {
+        buildCFG(beginFun, cfgCache);
+        cfgValid = true;
+        analysisComputed[ANALYSIS_CFG]++;
+    }
+    return cfgCache;
+}
+
+const Liveness& OptFunction::liveness() {
+    if (livenessValid) {
+        analysisReused[ANALYSIS_LIVENESS]++;
+        return livenessCache;
+    }
+    computeLiveness(cfg(), locals, true, livenessCache);
+    livenessValid = true;
+    analysisComputed[ANALYSIS_LIVENESS]++;
+    return livenessCache;
+}
+
+const std::vector<int>& OptFunction::dominators() {
+    if (dominatorsValid) {
+        analysisReused[ANALYSIS_DOMINATORS]++;
+        return dominatorsCache;
+    }
+    computeDominators(cfg(), dominatorsCache);
+    dominatorsValid = true;
+    analysisComputed[ANALYSIS_DOMINATORS]++;
+    return dominatorsCache;
+}
+
+const ReachingDefinitions& OptFunction::reachingDefinitions() {
+    if (reachingValid) {
+        analysisReused[ANALYSIS_REACHING]++;
+        return reachingCache;
+    }
+    computeReachingDefinitions(cfg(), locals, true, reachingCache);
+    reachingValid = true;
+    analysisComputed[ANALYSIS_REACHING]++;
+    return reachingCache;
+}
+
+const AvailableExpressions& OptFunction::availableExpressions() {
+    if (availableValid) {
+        analysisReused[ANALYSIS_AVAILABLE]++;
+        return availableCache;
+    }
+    computeAvailableExpressions(cfg(), locals, true, availableCache);
+    availableValid = true;
+    analysisComputed[ANALYSIS_AVAILABLE]++;
+    return availableCache;
+}
+
+void OptFunction::invalidate() {
+    cfgValid = false;
+    livenessValid = false;
+    dominatorsValid = false;
+    reachingValid = false;
+    availableValid = false;
+}
+
+void OptFunction::remove(TAC* tac) {
+    if (!tac || tac->type == TAC_BEGINFUN || tac->type == TAC_ENDFUN) return;
+    if (tac->prev) tac->prev->next = tac->next;
+    if (tac->next) tac->next->prev = tac->prev;
+    delete tac;
+}
+
+void OptFunction::moveBefore(TAC* tac, TAC* position) {
+    if (!tac || !position || tac == position || !position->prev) return;
+    if (tac->prev) tac->prev->next = tac->next;
+    if (tac->next) tac->next->prev = tac->prev;
+    tac->prev = position->prev;
+    tac->next = position;
+    position->prev->next = tac;
+    position->prev = tac;
+}
+
+// ==================== GERENCIADOR ====================
+
+// Roda a sequência uma vez; retorna o total de mudanças
+static int runPipeline(OptFunction& function, const int* pipeline) {
+    int total = 0;
+    for (const int* p = pipeline; *p >= 0; p++) {
+        auto start = std::chrono::steady_clock::now();
+        int changes = passList[*p].run(function);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        PassStats& stats = passStats[*p];
+        stats.runs++;
+        stats.changes += changes;
+        stats.nanoseconds += (unsigned long)elapsed.count();
+
+        if (changes > 0) {
+            function.invalidate();
+            total += changes;
+        }
+    }
+    return total;
+}
+
+void optimizeFunction(TAC* beginFun, const std::unordered_set<SymbolNode*>& locals, int level) {
+    if (!beginFun || beginFun->type != TAC_BEGINFUN || level <= OPT_LEVEL_NONE) return;
+
+    reportLevel = level;
+    functionsOptimized++;
+    OptFunction function(beginFun, locals);
+    if (level == OPT_LEVEL_BASIC) {
+        runPipeline(function, basicPipeline);
+        return;
+    }
+    for (int round = 0; round < OPT_MAX_ROUNDS; round++) {
+        if (runPipeline(function, fullPipeline) == 0) break;
+    }
+}
+
+void optimizeProgram(TAC* first, int level, ThreadPool& pool) {
+    if (level <= OPT_LEVEL_NONE) return;
+
+    // Inicializações globais (fora das funções) e código das funções, como
+    // na separação feita pelos backends
+    std::vector<TAC*> initTacs, funcTacs, begins;
+    bool inFunction = false;
+    for (TAC* t = first; t; t = t->next) {
+        if (t->type == TAC_BEGINFUN) {
+            inFunction = true;
+            begins.push_back(t);
+        }
+        (inFunction ? funcTacs : initTacs).push_back(t);
+        if (t->type == TAC_ENDFUN) inFunction = false;
+    }
+
+    std::unordered_set<SymbolNode*> locals, addressTaken;
+    findLocalSymbols(initTacs, funcTacs, locals, addressTaken);
+
+    // Cada passo só edita a própria função; os locais são só lidos
+    pool.parallelFor(begins.size(), [&](size_t f) {
+        optimizeFunction(begins[f], locals, level);
+    });
+}
+
+void optimizerPrintReport(FILE* output) {
+    fprintf(output, "\n===== Passos de otimizacao (-O%d, %lu funcoes) =====\n",
+            reportLevel.load(), functionsOptimized.load());
+    fprintf(output, "%-16s %11s %11s %13s\n", "Passo", "Execucoes", "Mudancas", "Tempo (ms)");
+    for (int p = 0; p < PASS_COUNT; p++) {
+        const PassStats& stats = passStats[p];
+        if (stats.runs == 0) continue;
+        fprintf(output, "%-16s %11lu %11lu %13.3f\n", passList[p].name, stats.runs.load(),
+                stats.changes.load(), stats.nanoseconds / 1e6);
+    }
+    fprintf(output, "%-16s %11s %11s\n", "Analise", "Calculada", "Reusada");
+    for (int a = 0; a < ANALYSIS_COUNT; a++) {
+        fprintf(output, "%-16s %11lu %11lu\n", analysisNames[a], analysisComputed[a].load(),
+                analysisReused[a].load());
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Compiladores - etapa7 - optimizer.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições do gerenciador de passos de otimização do TAC: cada nível
+ * (-O0, -O1, -O2) é uma sequência de transformações aplicadas a cada
+ * função, que compartilham as análises (CFG, vivência, dominadores,
+ * definições que alcançam e expressões disponíveis) enquanto nenhum passo
+ * altera o código
+ */
+
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include "cfg.hpp"
+#include "dataflow.hpp"
+#include "tac.hpp"
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+// Níveis de otimização
+#define OPT_LEVEL_NONE      0   // TAC como gerado
+#define OPT_LEVEL_BASIC     1   // Uma passada de cada transformação barata
+#define OPT_LEVEL_FULL      2   // Inclui invariantes e subexpressões, até estabilizar
+
+// Função em otimização: análises calculadas sob demanda e guardadas até
+// invalidate, e edição da lista de TACs da função
+class OptFunction {
+public:
+    // locals: símbolos (além dos temporários, sempre locais) que só esta
+    // função enxerga; só eles podem ser propagados ou eliminados
+    OptFunction(TAC* beginFun, const std::unordered_set<SymbolNode*>& locals);
+
+    TAC* begin() const { return beginFun; }
+
+    bool isLocal(SymbolNode* sym) const {
+        return sym && (sym->type == SYMBOL_TEMP || locals.count(sym));
+    }
+
+    // Análises; as referências valem até a próxima invalidação
+    const CFG& cfg();
+    const Liveness& liveness();             // Dos símbolos locais
+    const std::vector<int>& dominators();   // Dominador imediato por bloco
+    const ReachingDefinitions& reachingDefinitions();  // Dos símbolos locais
+    const AvailableExpressions& availableExpressions(); // Sobre os locais
+
+    // Descarta as análises (chamada pelo gerenciador quando um passo muda
+    // o código, ou pelo próprio passo entre etapas)
+    void invalidate();
+
+    // Remove e libera uma instrução (nunca TAC_BEGINFUN ou TAC_ENDFUN)
+    void remove(TAC* tac);
+
+    // Move uma instrução para imediatamente antes de position
+    void moveBefore(TAC* tac, TAC* position);
+
+private:
+    TAC* beginFun;
+    const std::unordered_set<SymbolNode*>& locals;
+    CFG cfgCache;
+    Liveness livenessCache;
+    std::vector<int> dominatorsCache;
+    ReachingDefinitions reachingCache;
+    AvailableExpressions availableCache;
+    bool cfgValid;
+    bool livenessValid;
+    bool dominatorsValid;
+    bool reachingValid;
+    bool availableValid;
+
+    OptFunction(const OptFunction&);
+    OptFunction& operator=(const OptFunction&);
+};
+
+class ThreadPool;
+
+// Otimiza cada função do programa (TACs em ordem de execução a partir de
+// first), em paralelo no pool; os locais são os de findLocalSymbols
+void optimizeProgram(TAC* first, int level, ThreadPool& pool);
+
+// Otimiza uma única função (compilação em fluxo), de TAC_BEGINFUN a
+// TAC_ENDFUN, com os símbolos declarados por ela como locais
+void optimizeFunction(TAC* beginFun, const std::unordered_set<SymbolNode*>& locals, int level);
+
+// Imprime, para cada passo, execuções, mudanças e tempo acumulados, e
+// quantas vezes cada análise foi calculada ou reaproveitada
+void optimizerPrintReport(FILE* output);
+
+#endif // OPTIMIZER_HPP
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include "symbols.hpp"
 #include "ast.hpp"
+#include "stream.hpp"
 
 using namespace std;
 
@@ -19,6 +20,9 @@ extern char* yytext;
 
 void yyerror(const char* msg);
 
+// Raiz da AST - todos os nodos criados nas ações abaixo (createNode,
+// createOperatorNode, createLeafNode, appendToList) vêm da arena astArena e
+// são liberados juntos por freeAST()
 ASTNode* programRoot = nullptr;
 
 // Contador de erros sintáticos para recuperação
@@ -60,7 +64,16 @@ program:
 
 global_declaration_list:
     /* empty */ { $$ = nullptr; }
-    | global_declaration_list global_declaration { $$ = createNode(AST_DECLARATION_LIST, nullptr, $1, $2, nullptr, nullptr); }
+    | global_declaration_list global_declaration {
+        // Na compilação em fluxo (--stream) cada declaração é compilada e
+        // liberada ao ser reduzida, e a lista do programa não é montada
+        if (streamEnabled()) {
+            streamDeclaration($2);
+            $$ = nullptr;
+        } else {
+            $$ = appendToList($1, AST_DECLARATION_LIST, $2);
+        }
+    }
     | global_declaration_list error {
         cerr << "Erro sintático na linha " << getLineNumber() << ": declaração global inválida" << endl;
         syntaxErrorCount++;
@@ -103,12 +116,12 @@ vector_declaration:
     ;
 
 literal_list:
-    literal { $$ = createNode(AST_LITERAL_LIST, nullptr, $1, nullptr, nullptr, nullptr); }
-    | literal_list literal { $$ = createNode(AST_LITERAL_LIST, nullptr, $1, $2, nullptr, nullptr); }
+    literal { $$ = appendToList(nullptr, AST_LITERAL_LIST, $1); }
+    | literal_list literal { $$ = appendToList($1, AST_LITERAL_LIST, $2); }
     ;
 
 function_declaration:
-    type TK_IDENTIFIER '(' parameter_list ')' local_variable_list block { $$ = createNode(AST_FUNCTION_DECLARATION, nullptr, $1, createLeafNode(AST_IDENTIFIER, $2), $4, createNode(AST_DECLARATION_LIST, nullptr, $6, $7, nullptr, nullptr)); }
+    type TK_IDENTIFIER '(' parameter_list ')' local_variable_list block { $$ = createNode(AST_FUNCTION_DECLARATION, nullptr, $1, createLeafNode(AST_IDENTIFIER, $2), $4, appendToList($6, AST_DECLARATION_LIST, $7)); }
     | type TK_IDENTIFIER '(' error ')' local_variable_list block {
         cerr << "Erro sintático na linha " << getLineNumber() << ": lista de parâmetros inválida" << endl;
         syntaxErrorCount++;
@@ -123,8 +136,8 @@ parameter_list:
     ;
 
 parameter_list_non_empty:
-    parameter { $$ = createNode(AST_PARAMETER_LIST, nullptr, $1, nullptr, nullptr, nullptr); }
-    | parameter_list_non_empty ',' parameter { $$ = createNode(AST_PARAMETER_LIST, nullptr, $1, $3, nullptr, nullptr); }
+    parameter { $$ = appendToList(nullptr, AST_PARAMETER_LIST, $1); }
+    | parameter_list_non_empty ',' parameter { $$ = appendToList($1, AST_PARAMETER_LIST, $3); }
     ;
 
 parameter:
@@ -133,7 +146,7 @@ parameter:
 
 local_variable_list:
     /* empty */ { $$ = nullptr; }
-    | local_variable_list variable_declaration { $$ = createNode(AST_DECLARATION_LIST, nullptr, $1, $2, nullptr, nullptr); }
+    | local_variable_list variable_declaration { $$ = appendToList($1, AST_DECLARATION_LIST, $2); }
     ;
 
 type:
@@ -163,7 +176,7 @@ block:
 
 command_list:
     /* empty */ { $$ = nullptr; }
-    | command_list command { $$ = createNode(AST_COMMAND_LIST, nullptr, $1, $2, nullptr, nullptr); }
+    | command_list command { $$ = appendToList($1, AST_COMMAND_LIST, $2); }
     ;
 
 command:
@@ -206,8 +219,8 @@ assignment:
     ;
 
 print_list:
-    print_element { $$ = createNode(AST_PRINT_LIST, nullptr, $1, nullptr, nullptr, nullptr); }
-    | print_list print_element { $$ = createNode(AST_PRINT_LIST, nullptr, $1, $2, nullptr, nullptr); }
+    print_element { $$ = appendToList(nullptr, AST_PRINT_LIST, $1); }
+    | print_list print_element { $$ = appendToList($1, AST_PRINT_LIST, $2); }
     ;
 
 print_element:
@@ -273,8 +286,8 @@ argument_list:
     ;
 
 argument_list_non_empty:
-    expression { $$ = createNode(AST_ARGUMENT_LIST, nullptr, $1, nullptr, nullptr, nullptr); }
-    | argument_list_non_empty ',' expression { $$ = createNode(AST_ARGUMENT_LIST, nullptr, $1, $3, nullptr, nullptr); }
+    expression { $$ = appendToList(nullptr, AST_ARGUMENT_LIST, $1); }
+    | argument_list_non_empty ',' expression { $$ = appendToList($1, AST_ARGUMENT_LIST, $3); }
     ;
 
 %%
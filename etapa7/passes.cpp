@@ -0,0 +1,513 @@
+/*
+ * Compiladores - etapa7 - passes.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação dos passos de otimização. Só símbolos locais (ver
+ * OptFunction::isLocal) são propagados ou eliminados: os globais podem
+ * ser lidos e escritos por outras funções e pelas inicializações. Nenhum
+ * passo remove ou antecipa operações que podem falhar na execução
+ * (divisão, acesso a vetor)
+ */
+
+#include "passes.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+// Desvios seguidos até o destino final (limite contra ciclos de desvios)
+#define JUMP_CHAIN_LIMIT    16
+
+// Operações sem efeito além de escrever res
+static bool isPure(TAC* tac) {
+    switch (tac->type) {
+        case TAC_MOVE:
+        case TAC_ADD: case TAC_SUB: case TAC_MUL:
+        case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+        case TAC_AND: case TAC_OR: case TAC_NOT: case TAC_NEG:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Comparação correspondente a um desvio com comparação (TAC_JLT -> TAC_LT)
+static int jumpComparison(int type) {
+    switch (type) {
+        case TAC_JLT: return TAC_LT;
+        case TAC_JGT: return TAC_GT;
+        case TAC_JLE: return TAC_LE;
+        case TAC_JGE: return TAC_GE;
+        case TAC_JEQ: return TAC_EQ;
+        case TAC_JNE: return TAC_DIF;
+        default:      return 0;
+    }
+}
+
+// ==================== DESVIOS ====================
+
+int passSimplifyJumps(OptFunction& function) {
+    int changes = 0;
+
+    // Desvio para um desvio incondicional vai direto ao destino final
+    {
+        const CFG& cfg = function.cfg();
+        int n = (int)cfg.tacs.size();
+        std::unordered_map<SymbolNode*, int> labelAt;
+        for (int i = 0; i < n; i++) {
+            if (cfg.tacs[i]->type == TAC_LABEL) labelAt[cfg.tacs[i]->res] = i;
+        }
+
+        for (TAC* t : cfg.tacs) {
+            if (!tacIsJump(t)) continue;
+            SymbolNode* target = t->res;
+            for (int hop = 0; hop < JUMP_CHAIN_LIMIT; hop++) {
+                auto it = labelAt.find(target);
+                if (it == labelAt.end()) break;
+                int p = it->second;
+                while (p < n && cfg.tacs[p]->type == TAC_LABEL) p++;
+                if (p == n || cfg.tacs[p]->type != TAC_JUMP || cfg.tacs[p] == t) break;
+                target = cfg.tacs[p]->res;
+            }
+            if (target != t->res) {
+                t->res = target;
+                changes++;
+            }
+        }
+        if (changes > 0) function.invalidate();
+    }
+
+    const CFG& cfg = function.cfg();
+    int n = (int)cfg.tacs.size();
+    std::vector<bool> removed(n, false);
+
+    // Blocos inalcançáveis a partir da entrada (TAC_ENDFUN fica)
+    std::vector<int> order;
+    cfg.reversePostorder(order);
+    std::vector<bool> reachable(cfg.blockCount(), false);
+    for (int b : order) reachable[b] = true;
+    for (int b = 0; b < cfg.blockCount(); b++) {
+        if (reachable[b]) continue;
+        for (int i = cfg.blocks[b].first; i <= cfg.blocks[b].last; i++) {
+            if (cfg.tacs[i]->type != TAC_ENDFUN) removed[i] = true;
+        }
+    }
+
+    // Desvio para o label que vem logo em seguida (só labels no caminho)
+    std::unordered_map<SymbolNode*, int> labelAt;
+    for (int i = 0; i < n; i++) {
+        if (cfg.tacs[i]->type == TAC_LABEL) labelAt[cfg.tacs[i]->res] = i;
+    }
+    for (int i = 0; i < n; i++) {
+        TAC* t = cfg.tacs[i];
+        if (removed[i] || !tacIsJump(t)) continue;
+        auto it = labelAt.find(t->res);
+        if (it == labelAt.end() || it->second <= i) continue;
+        bool next = true;
+        for (int p = i + 1; p < it->second && next; p++) {
+            next = removed[p] || cfg.tacs[p]->type == TAC_LABEL;
+        }
+        if (next) removed[i] = true;
+    }
+
+    // Labels que nenhum desvio restante referencia
+    std::unordered_map<SymbolNode*, int> references;
+    for (int i = 0; i < n; i++) {
+        if (!removed[i] && tacIsJump(cfg.tacs[i])) references[cfg.tacs[i]->res]++;
+    }
+    for (int i = 0; i < n; i++) {
+        TAC* t = cfg.tacs[i];
+        if (!removed[i] && t->type == TAC_LABEL && !references.count(t->res)) removed[i] = true;
+    }
+
+    std::vector<TAC*> dead;
+    for (int i = 0; i < n; i++) {
+        if (removed[i]) dead.push_back(cfg.tacs[i]);
+    }
+    for (TAC* t : dead) function.remove(t);
+    return changes + (int)dead.size();
+}
+
+// ==================== PROPAGAÇÃO ====================
+
+// Avalia a instrução se os operandos são constantes: operações viram
+// TAC_MOVE da constante e desvios condicionais viram TAC_JUMP ou somem
+// (removed). Operações com um só operando constante (ou o mesmo símbolo
+// nos dois) viram TAC_MOVE pelas identidades algébricas, como na geração
+// do TAC. Retorna true se mudou a instrução
+static bool foldInstruction(TAC* tac, bool& removed) {
+    removed = false;
+    int value;
+    switch (tac->type) {
+        case TAC_ADD: case TAC_SUB: case TAC_MUL: case TAC_DIV: case TAC_MOD:
+        case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+        case TAC_AND: case TAC_OR:
+            if (!isConstant(tac->op1) || !isConstant(tac->op2) ||
+                !tacFoldBinary(tac->type, constantValue(tac->op1), constantValue(tac->op2), value)) {
+                SymbolNode* simplified = tac->op1 && tac->op2 ?
+                    tacSimplifyBinary(tac->type, tac->op1, tac->op2) : nullptr;
+                if (!simplified) return false;
+                tac->type = TAC_MOVE;
+                tac->op1 = simplified;
+                tac->op2 = nullptr;
+                return true;
+            }
+            break;
+        case TAC_NOT:
+        case TAC_NEG:
+            if (!isConstant(tac->op1)) return false;
+            value = constantValue(tac->op1);
+            value = tac->type == TAC_NOT ? value == 0 : (int)(0u - (unsigned)value);
+            break;
+        case TAC_IFZ:
+        case TAC_IFNZ: {
+            if (!isConstant(tac->op1)) return false;
+            bool zero = constantValue(tac->op1) == 0;
+            if (zero == (tac->type == TAC_IFZ)) {
+                tac->type = TAC_JUMP;
+                tac->op1 = nullptr;
+            } else {
+                removed = true;
+            }
+            return true;
+        }
+        case TAC_JLT: case TAC_JGT: case TAC_JLE: case TAC_JGE: case TAC_JEQ: case TAC_JNE:
+            if (!isConstant(tac->op1) || !isConstant(tac->op2)) return false;
+            tacFoldBinary(jumpComparison(tac->type), constantValue(tac->op1),
+                          constantValue(tac->op2), value);
+            if (value) {
+                tac->type = TAC_JUMP;
+                tac->op1 = nullptr;
+                tac->op2 = nullptr;
+            } else {
+                removed = true;
+            }
+            return true;
+        default:
+            return false;
+    }
+
+    tac->type = TAC_MOVE;
+    tac->op1 = makeIntConstant(value);
+    tac->op2 = nullptr;
+    return true;
+}
+
+int passPropagate(OptFunction& function) {
+    const ReachingDefinitions& reaching = function.reachingDefinitions();
+    const CFG& cfg = function.cfg();
+    int changes = 0;
+    std::vector<TAC*> dead;
+
+    // Valor conhecido de cada local (constante ou outro local com o mesmo
+    // valor) e, para cada local, os que guardam cópia dele
+    std::unordered_map<SymbolNode*, SymbolNode*> known;
+    std::unordered_map<SymbolNode*, std::vector<SymbolNode*>> copies;
+
+    auto kill = [&](SymbolNode* sym) {
+        known.erase(sym);
+        auto it = copies.find(sym);
+        if (it == copies.end()) return;
+        for (SymbolNode* copy : it->second) {
+            auto k = known.find(copy);
+            if (k != known.end() && k->second == sym) known.erase(k);
+        }
+        copies.erase(it);
+    };
+
+    // Constante dada ao símbolo por todas as definições que alcançam a
+    // entrada do bloco (nullptr se alguma não é uma constante, ou se chega
+    // o valor de entrada da função). Mudanças deste passo preservam os
+    // valores, e desvios removidos só tiram caminhos: a análise continua
+    // válida até o fim do passo
+    auto constantAtEntry = [&](int block, int s) -> SymbolNode* {
+        SymbolNode* value = nullptr;
+        for (int d : reaching.ofSymbol[s]) {
+            if (!reaching.reachesIn(block, d)) continue;
+            if (reaching.site[d] < 0) return nullptr;
+            TAC* def = cfg.tacs[reaching.site[d]];
+            if (def->type != TAC_MOVE || !isConstant(def->op1)) return nullptr;
+            if (value && constantValue(value) != constantValue(def->op1)) return nullptr;
+            value = def->op1;
+        }
+        return value;
+    };
+
+    // Último bloco que escreveu cada símbolo que cruza blocos
+    const SymbolIndex& symbols = reaching.symbols;
+    std::vector<int> writtenIn(symbols.boundaryCount, -1);
+
+    for (int b = 0; b < cfg.blockCount(); b++) {
+        const BasicBlock& block = cfg.blocks[b];
+        known.clear();
+        copies.clear();
+        for (int i = block.first; i <= block.last; i++) {
+            TAC* t = cfg.tacs[i];
+
+            // Índices dos campos lidos (os campos ainda são os da análise)
+            const int* indices = symbols.usesAt(i);
+            SymbolNode** fields[2];
+            int count = tacUseFields(t, fields);
+            for (int u = 0; u < count; u++) {
+                SymbolNode* sym = *fields[u];
+                auto it = known.find(sym);
+                SymbolNode* value = nullptr;
+                if (it != known.end()) {
+                    value = it->second;
+                } else if (symbols.crossesBlocks(indices[u]) && writtenIn[indices[u]] != b) {
+                    value = constantAtEntry(b, indices[u]);
+                    if (value) known[sym] = value;
+                }
+                if (value) {
+                    *fields[u] = value;
+                    changes++;
+                }
+            }
+
+            bool removed;
+            if (foldInstruction(t, removed)) {
+                changes++;
+                if (removed) {
+                    dead.push_back(t);
+                    continue;
+                }
+            }
+
+            int d = symbols.definitionAt(i);
+            if (symbols.crossesBlocks(d)) writtenIn[d] = b;
+
+            SymbolNode* def = tacDefinition(t);
+            if (!function.isLocal(def)) continue;
+            kill(def);
+            if (t->type == TAC_MOVE && t->op1 != def &&
+                (isConstant(t->op1) || function.isLocal(t->op1))) {
+                known[def] = t->op1;
+                if (!isConstant(t->op1)) copies[t->op1].push_back(def);
+            }
+        }
+    }
+
+    for (TAC* t : dead) function.remove(t);
+    return changes;
+}
+
+// ==================== INVARIANTES DE LAÇO ====================
+
+// Laço natural: cabeçalho e blocos (arestas de volta para o mesmo
+// cabeçalho formam um único laço)
+struct NaturalLoop {
+    int header;
+    std::vector<int> blocks;
+};
+
+static void findLoops(const CFG& cfg, const std::vector<int>& idom, std::vector<NaturalLoop>& loops) {
+    std::unordered_map<int, int> loopOf;    // Cabeçalho -> laço
+    for (int b = 0; b < cfg.blockCount(); b++) {
+        for (int h : cfg.blocks[b].successors) {
+            if (!dominates(idom, h, b)) continue;
+
+            auto it = loopOf.find(h);
+            if (it == loopOf.end()) {
+                it = loopOf.insert(std::make_pair(h, (int)loops.size())).first;
+                loops.push_back(NaturalLoop());
+                loops.back().header = h;
+                loops.back().blocks.push_back(h);
+            }
+            NaturalLoop& loop = loops[it->second];
+
+            // Blocos que alcançam b sem passar pelo cabeçalho
+            std::vector<int> work(1, b);
+            while (!work.empty()) {
+                int x = work.back();
+                work.pop_back();
+                if (std::find(loop.blocks.begin(), loop.blocks.end(), x) != loop.blocks.end()) continue;
+                loop.blocks.push_back(x);
+                for (int p : cfg.blocks[x].predecessors) work.push_back(p);
+            }
+        }
+    }
+
+    // Internos primeiro: o que sobe de um laço interno ainda pode subir do
+    // externo na mesma passada
+    std::sort(loops.begin(), loops.end(), [](const NaturalLoop& a, const NaturalLoop& b) {
+        return a.blocks.size() < b.blocks.size();
+    });
+}
+
+int passHoistInvariants(OptFunction& function) {
+    const std::vector<int>& idom = function.dominators();
+    const Liveness& liveness = function.liveness();
+    const CFG& cfg = function.cfg();
+
+    std::vector<NaturalLoop> loops;
+    findLoops(cfg, idom, loops);
+    if (loops.empty()) return 0;
+
+    // Definições de cada símbolo na função inteira
+    std::unordered_map<SymbolNode*, int> definitions;
+    for (TAC* t : cfg.tacs) {
+        SymbolNode* def = tacDefinition(t);
+        if (def) definitions[def]++;
+    }
+
+    int changes = 0;
+    for (const NaturalLoop& loop : loops) {
+        // Só com um bloco que cai no cabeçalho vindo de fora do laço (o
+        // código inserido antes do label roda uma vez, na entrada)
+        const BasicBlock& header = cfg.blocks[loop.header];
+        int entry = loop.header - 1;
+        auto inLoop = [&](int b) {
+            return std::find(loop.blocks.begin(), loop.blocks.end(), b) != loop.blocks.end();
+        };
+        if (entry < 0 || inLoop(entry) || cfg.tacs[header.first]->type != TAC_LABEL) continue;
+        const std::vector<int>& entrySuccessors = cfg.blocks[entry].successors;
+        if (std::find(entrySuccessors.begin(), entrySuccessors.end(), loop.header) == entrySuccessors.end() ||
+            cfg.tacs[cfg.blocks[entry].last]->type == TAC_JUMP) {
+            continue;
+        }
+        bool singleEntry = true;
+        for (int p : header.predecessors) {
+            if (p != entry && !inLoop(p)) singleEntry = false;
+        }
+        if (!singleEntry) continue;
+
+        // Definições dentro do laço; com chamadas, globais podem mudar
+        std::vector<int> positions;
+        std::unordered_map<SymbolNode*, int> loopDefinitions;
+        bool hasCall = false;
+        for (int b : loop.blocks) {
+            for (int i = cfg.blocks[b].first; i <= cfg.blocks[b].last; i++) {
+                positions.push_back(i);
+                SymbolNode* def = tacDefinition(cfg.tacs[i]);
+                if (def) loopDefinitions[def]++;
+                if (cfg.tacs[i]->type == TAC_CALL) hasCall = true;
+            }
+        }
+        std::sort(positions.begin(), positions.end());
+
+        auto invariant = [&](SymbolNode* sym) {
+            if (!sym || isConstant(sym)) return true;
+            auto it = loopDefinitions.find(sym);
+            if (it != loopDefinitions.end() && it->second > 0) return false;
+            return function.isLocal(sym) || !hasCall;
+        };
+
+        // Temporário com uma única definição, não vivo na entrada do laço
+        // (nenhum uso vê o valor de antes da definição)
+        for (int i : positions) {
+            TAC* t = cfg.tacs[i];
+            SymbolNode* def = tacDefinition(t);
+            if (!isPure(t) || !def || def->type != SYMBOL_TEMP || definitions[def] != 1) continue;
+            int bit = liveness.indexOf(def);
+            if (bit >= 0 && liveness.isLiveIn(loop.header, bit)) continue;
+            if (!invariant(t->op1) || !invariant(t->op2)) continue;
+
+            function.moveBefore(t, cfg.tacs[header.first]);
+            loopDefinitions[def]--;
+            changes++;
+        }
+    }
+    return changes;
+}
+
+// ==================== SUBEXPRESSÕES COMUNS ====================
+
+// Uma divisão só é trocada por cópia quando a mesma divisão já rodou (sem
+// falhar) em todo caminho até ela, então nenhuma falha deixa de acontecer
+int passEliminateCommonExpressions(OptFunction& function) {
+    const AvailableExpressions& available = function.availableExpressions();
+    const CFG& cfg = function.cfg();
+    const SymbolIndex& symbols = available.symbols;
+    if (available.expressions.empty()) return 0;
+
+    // Expressões com a mesma operação e operandos (guardadas em símbolos
+    // diferentes)
+    std::unordered_map<Expression, std::vector<int>, ExpressionHash> sameOperation;
+    for (int e = 0; e < (int)available.expressions.size(); e++) {
+        Expression key = available.expressions[e];
+        key.res = nullptr;
+        sameOperation[key].push_back(e);
+    }
+
+    // Disponíveis no ponto atual, partindo de availableIn em cada bloco.
+    // Uma operação trocada por cópia continua deixando o valor no seu
+    // resultado, então a análise vale até o fim do passo
+    int changes = 0;
+    std::vector<uint64_t> current(available.words, 0);
+    for (int b = 0; b < cfg.blockCount(); b++) {
+        const BasicBlock& block = cfg.blocks[b];
+        std::copy(available.availableIn.begin() + b * available.words,
+                  available.availableIn.begin() + (b + 1) * available.words, current.begin());
+
+        for (int i = block.first; i <= block.last; i++) {
+            TAC* t = cfg.tacs[i];
+            int computed = available.indexOf(t);
+
+            Expression key = {t->type, t->op1, t->op2, nullptr};
+            auto it = sameOperation.find(key);
+            if (it != sameOperation.end()) {
+                for (int e : it->second) {
+                    SymbolNode* holder = available.expressions[e].res;
+                    if (holder == t->res || !bitTest(&current[0], e)) continue;
+                    t->type = TAC_MOVE;
+                    t->op1 = holder;
+                    t->op2 = nullptr;
+                    changes++;
+                    break;
+                }
+            }
+
+            if (computed >= 0) bitSet(&current[0], computed);
+            int d = symbols.definitionAt(i);
+            if (!symbols.crossesBlocks(d)) continue;
+            for (int e : available.usersOf[d]) bitClear(&current[0], e);
+        }
+    }
+    return changes;
+}
+
+// ==================== CÓDIGO MORTO ====================
+
+int passDeadCode(OptFunction& function) {
+    const Liveness& liveness = function.liveness();
+    const CFG& cfg = function.cfg();
+    const SymbolIndex& symbols = liveness.symbols;
+    std::vector<TAC*> dead;
+
+    // Vivos no ponto atual: os que cruzam blocos partem de liveOut; os
+    // locais a um bloco têm bits só aqui, zerados ao fim de cada bloco
+    std::vector<uint64_t> live(BITSET_WORDS(symbols.size()), 0);
+
+    // Para trás em cada bloco
+    for (int b = 0; b < cfg.blockCount(); b++) {
+        const BasicBlock& block = cfg.blocks[b];
+        std::copy(liveness.liveOut.begin() + b * liveness.words,
+                  liveness.liveOut.begin() + (b + 1) * liveness.words, live.begin());
+
+        for (int i = block.last; i >= block.first; i--) {
+            TAC* t = cfg.tacs[i];
+            int d = symbols.definitionAt(i);
+            bool selfMove = t->type == TAC_MOVE && t->op1 == tacDefinition(t);
+            if (t->type == TAC_SYMBOL ||
+                (isPure(t) && (selfMove || (d >= 0 && !bitTest(&live[0], d))))) {
+                dead.push_back(t);
+                continue;
+            }
+
+            // read pode manter o valor anterior (ver numberSymbols)
+            if (d >= 0 && t->type != TAC_READ) bitClear(&live[0], d);
+            const int* uses = symbols.usesAt(i);
+            for (int u = 0; u < 2; u++) {
+                if (uses[u] >= 0) bitSet(&live[0], uses[u]);
+            }
+        }
+
+        for (int i = block.first; i <= block.last; i++) {
+            const int* uses = symbols.usesAt(i);
+            for (int u = 0; u < 2; u++) {
+                if (uses[u] >= symbols.boundaryCount) bitClear(&live[0], uses[u]);
+            }
+        }
+    }
+
+    for (TAC* t : dead) function.remove(t);
+    return (int)dead.size();
+}
@@ -0,0 +1,37 @@
+/*
+ * Compiladores - etapa7 - passes.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições dos passos de otimização do TAC, rodados pelo gerenciador
+ * (optimizer.hpp) em cada função. Cada passo devolve o número de mudanças
+ * que fez (0 = código intacto, análises ainda válidas)
+ */
+
+#ifndef PASSES_HPP
+#define PASSES_HPP
+
+#include "optimizer.hpp"
+
+// Desvios: encadeia desvios para desvios, remove desvios para a instrução
+// seguinte, código inalcançável e labels sem referência
+int passSimplifyJumps(OptFunction& function);
+
+// Propagação de constantes e cópias dentro de cada bloco básico (e das
+// constantes que chegam de outros blocos, pelas definições que alcançam),
+// com a avaliação das operações e desvios que ficam só com constantes
+int passPropagate(OptFunction& function);
+
+// Invariantes de laço: operações puras de laços naturais cujos operandos
+// não mudam dentro do laço sobem para antes do cabeçalho
+int passHoistInvariants(OptFunction& function);
+
+// Subexpressões comuns: uma operação já calculada em todo caminho até ela
+// (expressão disponível, com os mesmos operandos sem mudança desde então)
+// vira cópia do símbolo que guardou o resultado
+int passEliminateCommonExpressions(OptFunction& function);
+
+// Código morto: operações puras cujo resultado local não é mais lido (e
+// os TAC_SYMBOL, que não geram instrução mas separam desvios de labels)
+int passDeadCode(OptFunction& function);
+
+#endif // PASSES_HPP
@@ -0,0 +1,291 @@
+/*
+ * Compiladores - etapa7 - regalloc.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Alocação de registradores por linear scan (Poletto & Sarkar):
+ * 1. análise de vivência por blocos básicos da função (dataflow.hpp);
+ * 2. um intervalo de vida [início, fim] por candidato;
+ * 3. varredura dos intervalos em ordem de início, derramando (spill) para a
+ *    memória o intervalo que termina mais tarde quando faltam registradores
+ */
+
+#include "regalloc.hpp"
+#include "ast.hpp"
+#include "cfg.hpp"
+#include "dataflow.hpp"
+#include <algorithm>
+#include <climits>
+
+// Intervalo de vida de um candidato (posições das instruções na função)
+struct LiveInterval {
+    SymbolNode* symbol;
+    int start;
+    int end;
+    bool needsCalleeSaved;  // Vivo durante uma chamada (ou parâmetro)
+    int reg;                // Registrador atribuído (-1 = memória)
+};
+
+// Instruções que chamam funções (do programa ou da libc)
+static bool isCallPoint(TAC* tac) {
+    return tac->type == TAC_CALL || tac->type == TAC_PRINT ||
+           tac->type == TAC_READ || tac->type == TAC_VEC_READ;
+}
+
+void findLocalSymbols(const std::vector<TAC*>& initTacs,
+                      const std::vector<TAC*>& funcTacs,
+                      std::unordered_set<SymbolNode*>& locals,
+                      std::unordered_set<SymbolNode*>& addressTaken) {
+    std::unordered_map<SymbolNode*, SymbolNode*> owner; // Símbolo -> função que o usa
+    std::unordered_set<SymbolNode*> excluded;
+
+    // function == nullptr indica uso nas inicializações globais
+    auto mark = [&](SymbolNode* sym, SymbolNode* function) {
+        if (!sym || sym->nature != NATURE_SCALAR) return;
+        if (sym->type != SYMBOL_IDENTIFIER && sym->type != SYMBOL_TEMP) return;
+        if (!function) {
+            excluded.insert(sym);
+            return;
+        }
+        auto it = owner.find(sym);
+        if (it == owner.end()) {
+            owner[sym] = function;
+        } else if (it->second != function) {
+            excluded.insert(sym);
+        }
+    };
+
+    SymbolNode* uses[2];
+    for (TAC* t : initTacs) {
+        int count = tacUses(t, uses);
+        for (int i = 0; i < count; i++) mark(uses[i], nullptr);
+        mark(tacDefinition(t), nullptr);
+    }
+
+    SymbolNode* function = nullptr;
+    for (TAC* t : funcTacs) {
+        if (t->type == TAC_BEGINFUN) {
+            function = t->res;
+            std::vector<SymbolNode*> params;
+            if (function) collectParameters(function->parameterList, params);
+            for (SymbolNode* param : params) mark(param, function);
+            continue;
+        }
+
+        // read precisa do endereço da variável
+        if (t->type == TAC_READ && t->res) {
+            addressTaken.insert(t->res);
+        }
+
+        int count = tacUses(t, uses);
+        for (int i = 0; i < count; i++) mark(uses[i], function);
+        mark(tacDefinition(t), function);
+    }
+
+    for (auto& pair : owner) {
+        if (!excluded.count(pair.first)) {
+            locals.insert(pair.first);
+        }
+    }
+}
+
+void allocateRegisters(const std::vector<TAC*>& funcTacs,
+                       const std::unordered_set<SymbolNode*>& candidates,
+                       const RegisterSet& regs, RegAllocation& allocation) {
+    int n = (int)funcTacs.size();
+    if (n == 0) return;
+
+    // ---------- Blocos básicos ----------
+    CFG cfg;
+    buildCFG(funcTacs, cfg);
+    int blockCount = cfg.blockCount();
+
+    // ---------- Vivência entre blocos ----------
+    // Numera os candidatos da função; só os lidos antes de escritos em algum
+    // bloco entram na análise de fluxo, os demais terão o intervalo exato
+    Liveness liveness;
+    computeLiveness(cfg, candidates, false, liveness);
+    const SymbolIndex& symbols = liveness.symbols;
+
+    // ---------- Ocorrências de cada candidato ----------
+    std::vector<int> intervalOf(symbols.size(), -1);
+    std::vector<LiveInterval> intervals;
+
+    auto touch = [&](SymbolNode* sym, int& index, int position) {
+        if (index < 0) {
+            index = (int)intervals.size();
+            LiveInterval iv = {sym, INT_MAX, -1, false, -1};
+            intervals.push_back(iv);
+        }
+        LiveInterval& iv = intervals[index];
+        iv.start = std::min(iv.start, position);
+        iv.end = std::max(iv.end, position);
+    };
+
+    // Parâmetros são definidos na entrada e copiados dos registradores de
+    // argumento no prólogo: ficam apenas em registradores preservados (os
+    // não usados no corpo não foram numerados). O prólogo é a posição -1 e
+    // todos ficam vivos até a posição 0, para que nenhum expire (e ceda o
+    // registrador a outro parâmetro) antes de todos serem copiados
+    std::vector<SymbolNode*> params;
+    if (funcTacs[0]->type == TAC_BEGINFUN && funcTacs[0]->res) {
+        collectParameters(funcTacs[0]->res->parameterList, params);
+    }
+    for (SymbolNode* param : params) {
+        int s = symbols.indexOf(param);
+        int unnumbered = -1;
+        if (s < 0 && !candidates.count(param)) continue;
+        int& index = s >= 0 ? intervalOf[s] : unnumbered;
+        touch(param, index, -1);
+        touch(param, index, 0);
+        intervals[index].needsCalleeSaved = true;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const int* uses = symbols.usesAt(i);
+        for (int u = 0; u < 2; u++) {
+            if (uses[u] >= 0) touch(symbols.symbols[uses[u]], intervalOf[uses[u]], i);
+        }
+        int d = symbols.definitionAt(i);
+        if (d >= 0) touch(symbols.symbols[d], intervalOf[d], i);
+    }
+
+    if (intervals.empty()) return;
+
+    // Estender os intervalos até as fronteiras dos blocos onde estão vivos
+    for (int s = 0; s < symbols.boundaryCount; s++) {
+        LiveInterval& iv = intervals[intervalOf[s]];
+        for (int b = 0; b < blockCount; b++) {
+            const BasicBlock& block = cfg.blocks[b];
+            if (liveness.isLiveIn(b, s)) {
+                iv.start = std::min(iv.start, block.first);
+                iv.end = std::max(iv.end, block.first);
+            }
+            if (liveness.isLiveOut(b, s)) {
+                iv.start = std::min(iv.start, block.last);
+                iv.end = std::max(iv.end, block.last);
+            }
+        }
+    }
+
+    // ---------- Intervalos que atravessam chamadas ----------
+    // callsBefore[i] = número de chamadas nas posições < i
+    std::vector<int> callsBefore(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        callsBefore[i + 1] = callsBefore[i] + (isCallPoint(funcTacs[i]) ? 1 : 0);
+    }
+    for (LiveInterval& iv : intervals) {
+        // Chamada estritamente dentro do intervalo destrói registradores temporários
+        if (iv.end > iv.start + 1 && callsBefore[iv.end] - callsBefore[iv.start + 1] > 0) {
+            iv.needsCalleeSaved = true;
+        }
+    }
+
+    // ---------- Linear scan ----------
+    std::vector<int> order(intervals.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (intervals[a].start != intervals[b].start) return intervals[a].start < intervals[b].start;
+        return intervals[a].end < intervals[b].end;
+    });
+
+    // Registradores livres (o de menor índice sai primeiro)
+    std::vector<int> freeCallee;
+    std::vector<int> freeCaller;
+    for (int r = regs.calleeSaved - 1; r >= 0; r--) freeCallee.push_back(r);
+    for (int r = regs.calleeSaved + regs.callerSaved - 1; r >= regs.calleeSaved; r--) freeCaller.push_back(r);
+
+    auto release = [&](int reg) {
+        if (reg < regs.calleeSaved) freeCallee.push_back(reg);
+        else freeCaller.push_back(reg);
+    };
+
+    // Intervalos ativos, ordenados pelo fim
+    std::vector<int> active;
+    auto activate = [&](int index) {
+        auto pos = std::upper_bound(active.begin(), active.end(), index, [&](int a, int b) {
+            return intervals[a].end < intervals[b].end;
+        });
+        active.insert(pos, index);
+    };
+
+    for (int index : order) {
+        LiveInterval& current = intervals[index];
+
+        // Liberar intervalos que terminaram (o último uso pode coincidir com
+        // a definição do atual: os operandos são lidos antes da escrita)
+        size_t expired = 0;
+        while (expired < active.size() && intervals[active[expired]].end <= current.start) {
+            release(intervals[active[expired]].reg);
+            expired++;
+        }
+        active.erase(active.begin(), active.begin() + expired);
+
+        if (!current.needsCalleeSaved && !freeCaller.empty()) {
+            current.reg = freeCaller.back();
+            freeCaller.pop_back();
+        } else if (!freeCallee.empty()) {
+            current.reg = freeCallee.back();
+            freeCallee.pop_back();
+        }
+
+        if (current.reg >= 0) {
+            activate(index);
+            continue;
+        }
+
+        // Sem registradores: derramar o intervalo compatível que termina mais tarde
+        int victim = -1;
+        for (int i = (int)active.size() - 1; i >= 0; i--) {
+            const LiveInterval& other = intervals[active[i]];
+            if (!current.needsCalleeSaved || other.reg < regs.calleeSaved) {
+                victim = i;
+                break;
+            }
+        }
+
+        allocation.spills++;
+        if (victim >= 0 && intervals[active[victim]].end > current.end) {
+            current.reg = intervals[active[victim]].reg;
+            intervals[active[victim]].reg = -1;
+            active.erase(active.begin() + victim);
+            activate(index);
+        }
+    }
+
+    // ---------- Resultado ----------
+    std::vector<bool> calleeUsed(regs.calleeSaved, false);
+    for (const LiveInterval& iv : intervals) {
+        if (iv.reg < 0) continue;
+        allocation.registers[iv.symbol] = iv.reg;
+        if (iv.reg < regs.calleeSaved) calleeUsed[iv.reg] = true;
+    }
+    for (int r = 0; r < regs.calleeSaved; r++) {
+        if (calleeUsed[r]) allocation.calleeSavedUsed.push_back(r);
+    }
+}
+
+void assignFrameSlots(const std::vector<TAC*>& funcTacs,
+                      const std::unordered_set<SymbolNode*>& locals,
+                      RegAllocation& allocation) {
+    auto reserve = [&](SymbolNode* sym) {
+        if (!sym || !locals.count(sym)) return;
+        if (allocation.registers.count(sym) || allocation.frameSlots.count(sym)) return;
+        allocation.frameBytes += 4;
+        allocation.frameSlots[sym] = allocation.frameBytes;
+    };
+
+    // Parâmetros primeiro (mesmo os não usados recebem valor no prólogo),
+    // depois os demais locais na ordem da primeira ocorrência
+    if (!funcTacs.empty() && funcTacs[0]->type == TAC_BEGINFUN && funcTacs[0]->res) {
+        std::vector<SymbolNode*> params;
+        collectParameters(funcTacs[0]->res->parameterList, params);
+        for (SymbolNode* param : params) reserve(param);
+    }
+
+    SymbolNode* uses[2];
+    for (TAC* t : funcTacs) {
+        int count = tacUses(t, uses);
+        for (int i = 0; i < count; i++) reserve(uses[i]);
+        reserve(tacDefinition(t));
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Compiladores - etapa7 - regalloc.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições para alocação de registradores (linear scan) sobre o TAC
+ */
+
+#ifndef REGALLOC_HPP
+#define REGALLOC_HPP
+
+#include "tac.hpp"
+#include "symbols.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Conjunto de registradores oferecido pelo backend
+// Índices 0..calleeSaved-1 são preservados pelas chamadas (podem guardar
+// valores vivos durante um call); os índices seguintes, até
+// calleeSaved+callerSaved-1, são destruídos por qualquer chamada
+struct RegisterSet {
+    int calleeSaved;
+    int callerSaved;
+};
+
+// Resultado da alocação para uma função
+struct RegAllocation {
+    std::unordered_map<SymbolNode*, int> registers;  // Símbolo -> índice do registrador
+    std::unordered_map<SymbolNode*, int> frameSlots; // Símbolo -> deslocamento no frame
+    std::vector<int> calleeSavedUsed;               // Registradores preservados a salvar no prólogo
+    int frameBytes;                                 // Bytes ocupados pelos slots do frame
+    int spills;                                     // Candidatos que ficaram em memória
+
+    RegAllocation() : frameBytes(0), spills(0) {}
+
+    // Registrador do símbolo, ou -1 se ele vive em memória
+    int location(SymbolNode* sym) const {
+        if (!sym) return -1;
+        auto it = registers.find(sym);
+        return it != registers.end() ? it->second : -1;
+    }
+
+    // Deslocamento (positivo, a partir da área de registradores salvos) do
+    // slot do símbolo no frame, ou 0 se ele não vive no frame
+    int frameSlot(SymbolNode* sym) const {
+        if (!sym) return 0;
+        auto it = frameSlots.find(sym);
+        return it != frameSlots.end() ? it->second : 0;
+    }
+};
+
+// Determina os símbolos locais a uma função: temporários, parâmetros e
+// variáveis locais escalares usados por uma única função e que não aparecem
+// nas inicializações globais. Locais lidos por read têm o endereço tomado
+// e são marcados em addressTaken (ficam no frame, nunca em registrador)
+// initTacs e funcTacs devem estar em ordem de execução
+void findLocalSymbols(const std::vector<TAC*>& initTacs,
+                      const std::vector<TAC*>& funcTacs,
+                      std::unordered_set<SymbolNode*>& locals,
+                      std::unordered_set<SymbolNode*>& addressTaken);
+
+// Aloca registradores para os candidatos usados na função
+// funcTacs contém a função inteira, de TAC_BEGINFUN a TAC_ENDFUN
+void allocateRegisters(const std::vector<TAC*>& funcTacs,
+                       const std::unordered_set<SymbolNode*>& candidates,
+                       const RegisterSet& regs, RegAllocation& allocation);
+
+// Reserva um slot de 4 bytes no frame para cada local da função que não
+// recebeu registrador (deve ser chamada após allocateRegisters)
+void assignFrameSlots(const std::vector<TAC*>& funcTacs,
+                      const std::unordered_set<SymbolNode*>& locals,
+                      RegAllocation& allocation);
+
+#endif // REGALLOC_HPP
@@ -63,7 +63,13 @@ bool SemanticAnalyzer::isLogicalOperator(int op) {
     return (op == AST_AND || op == AST_OR || op == AST_NOT);
 }
 
+// Tipo de uma expressão, anotado no nodo por annotateTypes
 int SemanticAnalyzer::inferExpressionType(ASTNode* node) {
+    return node ? node->dataType : 0;
+}
+
+// Calcula o tipo de um nodo a partir dos tipos já anotados nos filhos
+int SemanticAnalyzer::computeExpressionType(ASTNode* node) {
     if (!node) return 0;
 
     // Se é um literal, retorna o tipo do literal
@@ -108,8 +114,8 @@ int SemanticAnalyzer::inferExpressionType(ASTNode* node) {
         // Operadores aritméticos: retornam o tipo dos operandos
         // (assumindo que foram verificados e são compatíveis)
         if (isArithmeticOperator(op)) {
-            int leftType = inferExpressionType(node->child[0]);
-            int rightType = inferExpressionType(node->child[1]);
+            int leftType = node->child[0] ? node->child[0]->dataType : 0;
+            int rightType = node->child[1] ? node->child[1]->dataType : 0;
 
             // Se algum é float, retorna float
             if (leftType == DATATYPE_FLOAT || rightType == DATATYPE_FLOAT) {
@@ -128,9 +134,34 @@ int SemanticAnalyzer::inferExpressionType(ASTNode* node) {
     return 0;
 }
 
+void SemanticAnalyzer::annotateTypes(ASTNode* node) {
+    if (!node) return;
+
+    // Filhos primeiro: o tipo de um nodo depende apenas dos tipos dos filhos
+    // e dos símbolos, então cada nodo é calculado uma única vez
+    if (isListNode(node->type)) {
+        for (int i = 0; i < node->itemCount; i++) {
+            annotateTypes(node->items[i]);
+        }
+    } else {
+        for (int i = 0; i < 4; i++) {
+            annotateTypes(node->child[i]);
+        }
+    }
+    node->dataType = computeExpressionType(node);
+}
+
 void SemanticAnalyzer::firstPass(ASTNode* node) {
     if (!node) return;
 
+    // Processa os elementos das listas
+    if (isListNode(node->type)) {
+        for (int i = 0; i < node->itemCount; i++) {
+            firstPass(node->items[i]);
+        }
+        return;
+    }
+
     // Processa declaração de variável
     if (node->type == AST_VAR_DECLARATION) {
         if (node->child[0] && node->child[1] && node->child[1]->symbol) {
@@ -159,6 +190,9 @@ void SemanticAnalyzer::firstPass(ASTNode* node) {
             } else {
                 vecSymbol->nature = NATURE_VECTOR;
                 vecSymbol->dataType = getDataTypeFromString(typeStr);
+                if (node->child[2] && node->child[2]->symbol) {
+                    vecSymbol->vectorSize = atoi(node->child[2]->symbol->text.c_str());
+                }
             }
 
             // Verifica inicialização do vetor se houver
@@ -226,35 +260,18 @@ void SemanticAnalyzer::checkVectorInitialization(ASTNode* node) {
     int vectorSize = atoi(node->child[2]->symbol->text.c_str());
     int vectorDataType = getDataTypeFromString(node->child[0]->symbol->text);
 
-    // Conta elementos na lista de inicialização
-    int initCount = 0;
-    ASTNode* current = node->child[3];
-    while (current && current->type == AST_LITERAL_LIST) {
-        initCount++;
-        // Verifica o literal no child[0] se é o primeiro elemento
-        // ou no child[1] se é um elemento seguinte (estrutura recursiva)
-        ASTNode* literal = nullptr;
-        if (current->child[0] && current->child[0]->type == AST_LITERAL) {
-            literal = current->child[0];
-        } else if (current->child[1] && current->child[1]->type == AST_LITERAL) {
-            literal = current->child[1];
-        }
-
-        if (literal && literal->symbol) {
-            // Verifica tipo do literal
+    // Verifica o tipo de cada literal da lista de inicialização
+    ASTNode* list = node->child[3];
+    int initCount = list->type == AST_LITERAL_LIST ? list->itemCount : 0;
+    for (int i = 0; i < initCount; i++) {
+        ASTNode* literal = list->items[i];
+        if (literal->type == AST_LITERAL && literal->symbol) {
             int litType = getDataTypeFromLiteral(literal->symbol->type);
             if (!areTypesCompatible(vectorDataType, litType)) {
                 reportError("Tipo incompatível na inicialização do vetor '" +
                            node->child[1]->symbol->text + "'");
             }
         }
-
-        // Avança para o próximo na lista
-        if (current->child[0] && current->child[0]->type == AST_LITERAL_LIST) {
-            current = current->child[0];
-        } else {
-            break;
-        }
     }
 
     // Verifica se o número de inicializadores é compatível com o tamanho
@@ -267,6 +284,14 @@ void SemanticAnalyzer::checkVectorInitialization(ASTNode* node) {
 void SemanticAnalyzer::secondPass(ASTNode* node, int functionReturnType) {
     if (!node) return;
 
+    // Processa os elementos das listas
+    if (isListNode(node->type)) {
+        for (int i = 0; i < node->itemCount; i++) {
+            secondPass(node->items[i], functionReturnType);
+        }
+        return;
+    }
+
     // Processa comandos verificando tipos
     switch (node->type) {
         case AST_ASSIGNMENT:
@@ -490,44 +515,27 @@ void SemanticAnalyzer::checkExpression(ASTNode* node) {
 }
 
 int SemanticAnalyzer::countParameters(ASTNode* paramList) {
-    if (!paramList) return 0;
-    int count = 0;
-    ASTNode* current = paramList;
-    while (current && current->type == AST_PARAMETER_LIST) {
-        count++;
-        current = current->child[0];
-    }
-    return count;
+    if (!paramList || paramList->type != AST_PARAMETER_LIST) return 0;
+    return paramList->itemCount;
 }
 
 int SemanticAnalyzer::countArguments(ASTNode* argList) {
-    if (!argList) return 0;
-    int count = 0;
-    ASTNode* current = argList;
-    while (current && current->type == AST_ARGUMENT_LIST) {
-        count++;
-        current = current->child[0];
-    }
-    return count;
+    if (!argList || argList->type != AST_ARGUMENT_LIST) return 0;
+    return argList->itemCount;
 }
 
 bool SemanticAnalyzer::checkParameterArgumentCompatibility(ASTNode* params, ASTNode* args) {
     if (!params && !args) return true;
     if (!params || !args) return false;
+    if (params->type != AST_PARAMETER_LIST || args->type != AST_ARGUMENT_LIST) return true;
 
-    ASTNode* currentParam = params;
-    ASTNode* currentArg = args;
-
-    while (currentParam && currentParam->type == AST_PARAMETER_LIST &&
-           currentArg && currentArg->type == AST_ARGUMENT_LIST) {
-
-        // Determine where the actual parameter and argument are
-        // If child[1] exists and is not null, it's there (multiple params case)
-        // Otherwise, it's in child[0] (single param case)
-        ASTNode* param = currentParam->child[1] ? currentParam->child[1] : currentParam->child[0];
-        ASTNode* arg = currentArg->child[1] ? currentArg->child[1] : currentArg->child[0];
+    // Compara cada parâmetro com o argumento na mesma posição
+    int count = params->itemCount < args->itemCount ? params->itemCount : args->itemCount;
+    for (int i = 0; i < count; i++) {
+        ASTNode* param = params->items[i];
+        ASTNode* arg = args->items[i];
 
-        if (param && param->type == AST_PARAMETER) {
+        if (param->type == AST_PARAMETER) {
             int paramType = getDataTypeFromString(param->child[0]->symbol->text);
             int argType = inferExpressionType(arg);
 
@@ -536,9 +544,6 @@ bool SemanticAnalyzer::checkParameterArgumentCompatibility(ASTNode* params, ASTN
                 return false;
             }
         }
-
-        currentParam = currentParam->child[0];
-        currentArg = currentArg->child[0];
     }
 
     return true;
@@ -582,19 +587,24 @@ void SemanticAnalyzer::checkFunctionCall(ASTNode* node) {
     }
 }
 
-bool SemanticAnalyzer::analyze(ASTNode* root) {
+bool SemanticAnalyzer::analyze(ASTNode* root, bool verbose) {
     errorCount = 0;
 
-    cout << "\n========== ANÁLISE SEMÂNTICA ==========" << endl;
+    if (verbose) {
+        cout << "\n========== ANÁLISE SEMÂNTICA ==========" << endl;
+        cout << "Primeira passagem: registrando declarações..." << endl;
+    }
 
     // Primeira passagem: registra declarações
-    cout << "Primeira passagem: registrando declarações..." << endl;
     firstPass(root);
+    annotateTypes(root);
 
     // Segunda passagem: verifica usos e tipos
-    cout << "Segunda passagem: verificando usos e tipos..." << endl;
+    if (verbose) cout << "Segunda passagem: verificando usos e tipos..." << endl;
     secondPass(root, 0);
 
+    if (!verbose) return (errorCount == 0);
+
     if (errorCount == 0) {
         cout << "Análise semântica concluída: SEM ERROS" << endl;
     } else {
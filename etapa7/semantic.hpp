@@ -21,6 +21,7 @@ private:
     int getDataTypeFromString(const std::string& typeStr);
     int getDataTypeFromLiteral(int literalType);
     int inferExpressionType(ASTNode* node);
+    int computeExpressionType(ASTNode* node);
     bool isArithmeticOperator(int op);
     bool isRelationalOperator(int op);
     bool isLogicalOperator(int op);
@@ -33,12 +34,16 @@ private:
 public:
     SemanticAnalyzer();
 
-    // Função principal de análise
-    bool analyze(ASTNode* root);
+    // Função principal de análise (verbose imprime o andamento em stdout)
+    bool analyze(ASTNode* root, bool verbose = true);
 
     // Primeira passada: registrar declarações
     void firstPass(ASTNode* node);
 
+    // Anota em cada nodo o tipo de dado da expressão, de baixo para cima
+    // (após a primeira passada, que define os tipos dos identificadores)
+    void annotateTypes(ASTNode* node);
+
     // Segunda passada: verificar usos e tipos
     void secondPass(ASTNode* node, int functionReturnType = 0);
 
@@ -0,0 +1,215 @@
+/*
+ * Compiladores - etapa7 - stream.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação da compilação em fluxo. A memória usada fica limitada pela
+ * maior função do programa: a arena da AST, o TAC e os temporários e labels
+ * são liberados após cada declaração. Crescem com o programa apenas a tabela
+ * de símbolos, as listas de parâmetros (copiadas para uma arena própria,
+ * pois as chamadas as consultam) e as funções adiadas
+ */
+
+#include "stream.hpp"
+#include "asm.hpp"
+#include "optimizer.hpp"
+#include "semantic.hpp"
+#include "tac.hpp"
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// Contador de erros sintáticos (definido no parser.y)
+extern int syntaxErrorCount;
+
+static bool enabled = false;
+static FILE* streamOutput = nullptr;
+static int streamTarget = ASM_TARGET_ARM64;
+static int streamOptLevel = 0;
+
+// A análise semântica é a mesma do modo normal, aplicada por declaração
+static SemanticAnalyzer analyzer;
+static int streamErrors = 0;
+
+// Nodos que sobrevivem à liberação de astArena: listas de parâmetros e
+// funções adiadas
+static ASTArena retainedArena;
+static vector<ASTNode*> deferredFunctions;
+
+// Parâmetros e variáveis locais de todas as funções já vistas
+static unordered_set<SymbolNode*> functionSymbols;
+
+static int functionCount = 0;
+
+static void reportError(const string& message) {
+    cerr << "ERRO SEMÂNTICO: " << message << endl;
+    streamErrors++;
+}
+
+// Após o primeiro erro (sintático ou semântico) nada mais é emitido, mas a
+// análise continua para mostrar todos os erros
+static bool hasErrors() {
+    return syntaxErrorCount > 0 || analyzer.getErrorCount() > 0 || streamErrors > 0;
+}
+
+// Parâmetros e variáveis locais declarados pela função
+static void collectOwnSymbols(ASTNode* function, unordered_set<SymbolNode*>& own) {
+    vector<SymbolNode*> params;
+    collectParameters(function->child[2], params);
+    own.insert(params.begin(), params.end());
+
+    ASTNode* locals = function->child[3];
+    for (int i = 0; locals && i < locals->itemCount; i++) {
+        ASTNode* item = locals->items[i];
+        if (item->type == AST_VAR_DECLARATION && item->child[1] && item->child[1]->symbol) {
+            own.insert(item->child[1]->symbol);
+        }
+    }
+}
+
+// Símbolos dos identificadores usados na subárvore
+static void collectReferences(ASTNode* node, vector<SymbolNode*>& references) {
+    if (!node) return;
+
+    if (node->type == AST_IDENTIFIER && node->symbol) {
+        references.push_back(node->symbol);
+    }
+    if (isListNode(node->type)) {
+        for (int i = 0; i < node->itemCount; i++) {
+            collectReferences(node->items[i], references);
+        }
+    } else {
+        for (int i = 0; i < 4; i++) {
+            collectReferences(node->child[i], references);
+        }
+    }
+}
+
+// Analisa, traduz e emite uma função cujos símbolos já estão todos declarados
+static void compileFunction(ASTNode* function) {
+    unordered_set<SymbolNode*> own;
+    collectOwnSymbols(function, own);
+
+    analyzer.annotateTypes(function);
+    analyzer.secondPass(function, 0);
+
+    // Sem o programa inteiro não se sabe se um local será usado por outra
+    // função (no modo normal ele iria para a memória global): esse uso é
+    // recusado em vez de gerar código com semântica diferente
+    vector<SymbolNode*> references;
+    collectReferences(function->child[3], references);
+    unordered_set<SymbolNode*> reported;
+    for (SymbolNode* sym : references) {
+        if (functionSymbols.count(sym) && !own.count(sym) && reported.insert(sym).second) {
+            reportError("Variável '" + sym->text + "' pertence a outra função "
+                        "(não suportado na compilação em fluxo)");
+        }
+    }
+
+    functionCount++;
+    if (hasErrors()) return;
+
+    TACCode code = generateTAC(function);
+    optimizeFunction(code.first, own, streamOptLevel);
+    vector<TAC*> tacs;
+    for (TAC* t = code.first; t; t = t->next) {
+        tacs.push_back(t);
+    }
+    generateAsmFunction(tacs, own, streamOutput, streamTarget);
+
+    tacFree(code.first);
+    symbolTable->releaseGenerated();
+}
+
+// Emite uma variável ou vetor global com os valores iniciais em .data
+static void compileGlobal(ASTNode* declaration) {
+    if (hasErrors() || !declaration->child[1] || !declaration->child[1]->symbol) return;
+
+    vector<SymbolNode*> values;
+    if (declaration->type == AST_VAR_DECLARATION) {
+        if (declaration->child[2]) values.push_back(declaration->child[2]->symbol);
+    } else if (declaration->child[3]) {
+        ASTNode* literals = declaration->child[3];
+        for (int i = 0; i < literals->itemCount; i++) {
+            values.push_back(literals->items[i]->symbol);
+        }
+    }
+    generateAsmGlobal(declaration->child[1]->symbol, values, streamOutput, streamTarget);
+}
+
+void streamBegin(FILE* output, int target, bool lean, int optLevel) {
+    enabled = true;
+    streamOutput = output;
+    streamTarget = target;
+    streamOptLevel = optLevel;
+    generateAsmBegin(output, target, lean);
+}
+
+bool streamEnabled() {
+    return enabled;
+}
+
+void streamDeclaration(ASTNode* declaration) {
+    if (declaration) {
+        analyzer.firstPass(declaration);
+
+        if (declaration->type == AST_VAR_DECLARATION ||
+            declaration->type == AST_VECTOR_DECLARATION) {
+            compileGlobal(declaration);
+        } else if (declaration->type == AST_FUNCTION_DECLARATION &&
+                   declaration->child[1] && declaration->child[1]->symbol) {
+            SymbolNode* funcSymbol = declaration->child[1]->symbol;
+            unordered_set<SymbolNode*> own;
+            collectOwnSymbols(declaration, own);
+
+            // Referência à frente: chamada de função ou global declarada
+            // mais adiante (ou nunca, o que será um erro ao final)
+            vector<SymbolNode*> references;
+            collectReferences(declaration->child[3], references);
+            bool forward = false;
+            for (SymbolNode* sym : references) {
+                if (sym->nature == 0) {
+                    forward = true;
+                    break;
+                }
+            }
+
+            // A lista de parâmetros registrada na primeira passagem precisa
+            // sobreviver à arena (é consultada nas chamadas e no prólogo)
+            bool ownsParameters = funcSymbol->parameterList == declaration->child[2];
+            if (forward) {
+                ASTNode* copy = cloneAST(declaration, retainedArena);
+                if (ownsParameters) funcSymbol->parameterList = copy->child[2];
+                deferredFunctions.push_back(copy);
+            } else {
+                compileFunction(declaration);
+                if (ownsParameters) {
+                    funcSymbol->parameterList = cloneAST(declaration->child[2], retainedArena);
+                }
+            }
+
+            functionSymbols.insert(own.begin(), own.end());
+        }
+    }
+
+    // Nenhum outro nodo da arena está vivo na pilha do parser neste ponto
+    freeAST();
+}
+
+int streamEnd() {
+    // Agora todas as declarações do fonte foram vistas
+    for (ASTNode* function : deferredFunctions) {
+        compileFunction(function);
+    }
+
+    cout << "Compilação em fluxo: " << functionCount << " função(ões), "
+         << deferredFunctions.size() << " adiada(s) por referências à frente" << endl;
+
+    if (!hasErrors()) {
+        generateAsmEnd(streamOutput, streamTarget);
+    }
+
+    deferredFunctions.clear();
+    return analyzer.getErrorCount() + streamErrors;
+}
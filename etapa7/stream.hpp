@@ -0,0 +1,33 @@
+/*
+ * Compiladores - etapa7 - stream.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições para a compilação em fluxo (--stream): cada declaração global
+ * é analisada, traduzida para TAC, emitida em assembly e liberada assim que
+ * o parser a reduz, sem montar a AST do programa inteiro
+ */
+
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include "ast.hpp"
+#include <cstdio>
+
+// Habilita o modo em fluxo e emite o cabeçalho do assembly em output (lean
+// omite os comentários do assembly; optLevel é o nível de otimização do TAC
+// de cada função, ver optimizer.hpp)
+void streamBegin(FILE* output, int target, bool lean = false, int optLevel = 0);
+
+// Indica se o modo em fluxo está habilitado (consultado pelo parser)
+bool streamEnabled();
+
+// Processa uma declaração global recém-reduzida e libera os nodos da arena
+// da AST. Funções que usam símbolos ainda não declarados (chamadas ou
+// globais mais adiante no fonte) são copiadas e adiadas até streamEnd
+void streamDeclaration(ASTNode* declaration);
+
+// Compila as funções adiadas e encerra o assembly; retorna o número de erros
+// semânticos (com erros, o assembly emitido fica incompleto)
+int streamEnd();
+
+#endif // STREAM_HPP
@@ -6,48 +6,175 @@
  */
 
 #include "symbols.hpp"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <new>
 
 // Instância global da tabela de símbolos
 SymbolTable *symbolTable = nullptr;
 
-SymbolTable::SymbolTable() { table.clear(); }
+// Capacidade inicial da tabela hash (potência de 2)
+static const size_t INITIAL_SLOTS = 1024;
+
+SymbolTable::SymbolTable()
+    : slots(INITIAL_SLOTS, nullptr), count(0), blockUsed(BLOCK_NODES), generatedUsed(BLOCK_NODES) {}
 
 SymbolTable::~SymbolTable() { clear(); }
 
+unsigned SymbolTable::hashLexeme(const char *lexeme, size_t length) {
+  unsigned hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char)lexeme[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+size_t SymbolTable::findSlot(const char *lexeme, size_t length, unsigned hash) const {
+  size_t mask = slots.size() - 1;
+  size_t index = hash & mask;
+
+  // Sondagem linear: compara o hash antes de comparar o texto
+  while (slots[index]) {
+    const SymbolNode *node = slots[index];
+    if (node->hash == hash && node->text.size() == length &&
+        node->text.compare(0, length, lexeme, length) == 0) {
+      return index;
+    }
+    index = (index + 1) & mask;
+  }
+  return index;
+}
+
+void SymbolTable::grow() {
+  std::vector<SymbolNode *> old(slots.size() * 2, nullptr);
+  old.swap(slots);
+
+  // Reinserir usando o hash já armazenado em cada nodo
+  size_t mask = slots.size() - 1;
+  for (SymbolNode *node : old) {
+    if (!node) continue;
+    size_t index = node->hash & mask;
+    while (slots[index]) {
+      index = (index + 1) & mask;
+    }
+    slots[index] = node;
+  }
+}
+
+SymbolNode *SymbolTable::allocateNode(std::vector<SymbolNode *> &arena, size_t &used,
+                                      int type, const char *lexeme, size_t length) {
+  if (used == BLOCK_NODES) {
+    arena.push_back(static_cast<SymbolNode *>(
+        ::operator new(BLOCK_NODES * sizeof(SymbolNode))));
+    used = 0;
+  }
+
+  SymbolNode *node = new (arena.back() + used) SymbolNode(type, std::string(lexeme, length));
+  used++;
+  return node;
+}
+
+void SymbolTable::releaseNodes(std::vector<SymbolNode *> &arena, size_t &used) {
+  // Destruir os nodos (liberam suas strings) e devolver os blocos
+  for (size_t b = 0; b < arena.size(); b++) {
+    size_t count = (b + 1 == arena.size()) ? used : BLOCK_NODES;
+    for (size_t i = 0; i < count; i++) {
+      arena[b][i].~SymbolNode();
+    }
+    ::operator delete(arena[b]);
+  }
+  arena.clear();
+  used = BLOCK_NODES;
+}
+
 SymbolNode *SymbolTable::insert(const std::string &lexeme, int type) {
+  return insert(lexeme.data(), lexeme.size(), type);
+}
+
+SymbolNode *SymbolTable::insert(const char *lexeme, size_t length, int type) {
+  unsigned hash = hashLexeme(lexeme, length);
+  size_t index = findSlot(lexeme, length, hash);
+
   // Se o símbolo já existe, retorna o nodo existente
-  auto it = table.find(lexeme);
-  if (it != table.end()) {
-    return it->second;
+  if (slots[index]) {
+    return slots[index];
   }
 
   // Criar novo nodo
-  SymbolNode *node = new SymbolNode(type, lexeme);
-  table[lexeme] = node;
+  SymbolNode *node = allocateNode(blocks, blockUsed, type, lexeme, length);
+  node->hash = hash;
+  slots[index] = node;
+  count++;
+
+  // Manter fator de carga abaixo de 1/2
+  if (count * 2 > slots.size()) {
+    grow();
+  }
+
+  return node;
+}
+
+SymbolNode *SymbolTable::insertLiteral(const std::string &lexeme, int type) {
+  SymbolNode *node = lookup(lexeme);
+  if (node && node->type == type) return node;
+
+  std::string key = std::to_string(type) + ":" + lexeme;
+  auto it = literals.find(key);
+  if (it != literals.end()) return it->second;
+
+  node = allocateNode(blocks, blockUsed, type, lexeme.data(), lexeme.size());
+  node->hash = hashLexeme(lexeme.data(), lexeme.size());
+  literals[key] = node;
+  return node;
+}
 
+SymbolNode *SymbolTable::createGenerated(int type, int id, SymbolNode *owner) {
+  std::lock_guard<std::mutex> lock(generatedMutex);
+  SymbolNode *node = allocateNode(generatedBlocks, generatedUsed, type, "", 0);
+  node->id = id;
+  node->owner = owner;
   return node;
 }
 
+void SymbolTable::releaseGenerated() {
+  std::lock_guard<std::mutex> lock(generatedMutex);
+  releaseNodes(generatedBlocks, generatedUsed);
+}
+
 SymbolNode *SymbolTable::lookup(const std::string &lexeme) {
-  auto it = table.find(lexeme);
-  if (it != table.end()) {
-    return it->second;
-  }
-  return nullptr;
+  return lookup(lexeme.data(), lexeme.size());
+}
+
+SymbolNode *SymbolTable::lookup(const char *lexeme, size_t length) {
+  return slots[findSlot(lexeme, length, hashLexeme(lexeme, length))];
 }
 
 void SymbolTable::clear() {
-  for (auto &pair : table) {
-    delete pair.second;
-  }
-  table.clear();
+  releaseNodes(blocks, blockUsed);
+  releaseNodes(generatedBlocks, generatedUsed);
+
+  slots.assign(INITIAL_SLOTS, nullptr);
+  literals.clear();
+  count = 0;
 }
 
 bool SymbolTable::exists(const std::string &lexeme) {
-  return table.find(lexeme) != table.end();
+  return lookup(lexeme) != nullptr;
+}
+
+std::vector<SymbolNode *> SymbolTable::sortedSymbols() const {
+  std::vector<SymbolNode *> symbols;
+  symbols.reserve(count);
+  for (SymbolNode *node : slots) {
+    if (node) symbols.push_back(node);
+  }
+  std::sort(symbols.begin(), symbols.end(),
+            [](const SymbolNode *a, const SymbolNode *b) { return a->text < b->text; });
+  return symbols;
 }
 
 std::string SymbolTable::getTypeName(int type) {
@@ -64,6 +191,10 @@ std::string SymbolTable::getTypeName(int type) {
     return "LIT_STRING";
   case SYMBOL_IDENTIFIER:
     return "IDENTIFIER";
+  case SYMBOL_TEMP:
+    return "TEMP";
+  case SYMBOL_LABEL:
+    return "LABEL";
   default:
     return "UNKNOWN";
   }
@@ -103,18 +234,18 @@ void SymbolTable::printTable() {
             << std::setw(12) << "NATUREZA" << std::setw(10) << "DATA_TYPE" << std::endl;
   std::cout << "--------------------------------------------------------" << std::endl;
 
-  if (table.empty()) {
+  if (count == 0) {
     std::cout << "Tabela vazia" << std::endl;
   } else {
-    for (const auto &pair : table) {
-      std::cout << std::left << std::setw(20) << pair.first << std::setw(15)
-                << getTypeName(pair.second->type) << std::setw(12)
-                << getNatureName(pair.second->nature) << std::setw(10)
-                << getDataTypeName(pair.second->dataType) << std::endl;
+    for (const SymbolNode *node : sortedSymbols()) {
+      std::cout << std::left << std::setw(20) << node->text << std::setw(15)
+                << getTypeName(node->type) << std::setw(12)
+                << getNatureName(node->nature) << std::setw(10)
+                << getDataTypeName(node->dataType) << std::endl;
     }
   }
   std::cout << "========================================================" << std::endl;
-  std::cout << "Total de símbolos: " << table.size() << std::endl << std::endl;
+  std::cout << "Total de símbolos: " << count << std::endl << std::endl;
 }
 
 void initSymbolTable() {
@@ -130,29 +261,91 @@ void finalizeSymbolTable() {
   }
 }
 
-// Contadores globais para geração de temporários e labels
-static int tempCounter = 0;
-static int labelCounter = 0;
+// Contadores de temporários e labels da função em tradução: um por thread,
+// já que cada thread traduz uma função por vez
+static thread_local int tempCounter = 0;
+static thread_local int labelCounter = 0;
+static thread_local SymbolNode* currentFunction = nullptr;
 
-// Função para criar símbolo temporário
-SymbolNode* makeTemp() {
-  char buffer[128];
-  snprintf(buffer, sizeof(buffer), "__temp%d", tempCounter++);
+// Trava da internação de constantes (a tabela hash não é thread-safe)
+static std::mutex constantMutex;
 
-  // Criar símbolo na tabela de símbolos
-  SymbolNode* temp = symbolTable->insert(std::string(buffer), SYMBOL_IDENTIFIER);
-  temp->nature = NATURE_SCALAR;
+// Função para começar a numeração de uma função
+void beginFunctionSymbols(SymbolNode* function) {
+  tempCounter = 0;
+  labelCounter = 0;
+  currentFunction = function;
+}
 
+// Função para criar símbolo temporário
+SymbolNode* makeTemp(int dataType) {
+  SymbolNode* temp = symbolTable->createGenerated(SYMBOL_TEMP, tempCounter++, currentFunction);
+  temp->nature = NATURE_SCALAR;
+  temp->dataType = dataType;
   return temp;
 }
 
 // Função para criar label
 SymbolNode* makeLabel() {
-  char buffer[128];
-  snprintf(buffer, sizeof(buffer), "__label%d", labelCounter++);
+  return symbolTable->createGenerated(SYMBOL_LABEL, labelCounter++, currentFunction);
+}
+
+int tempCount() { return tempCounter; }
+
+int labelCount() { return labelCounter; }
 
-  // Criar símbolo na tabela de símbolos
-  SymbolNode* label = symbolTable->insert(std::string(buffer), SYMBOL_IDENTIFIER);
+// Função para obter o nome de um símbolo, formatando temporários e labels
+// sob demanda
+const std::string& symbolName(SymbolNode* sym) {
+  if (sym->text.empty() && sym->id >= 0) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), sym->type == SYMBOL_LABEL ? "label%d" : "temp%d", sym->id);
+    sym->text = sym->owner ? "__" + sym->owner->text + "_" + buffer : std::string("__") + buffer;
+  }
+  return sym->text;
+}
 
-  return label;
-}
\ No newline at end of file
+// Função para verificar se o símbolo é uma constante
+bool isConstant(SymbolNode* sym) {
+  if (!sym) return false;
+  return sym->type == SYMBOL_LIT_INT || sym->type == SYMBOL_LIT_CHAR ||
+         sym->type == SYMBOL_LIT_BOOL;
+}
+
+// Função para obter o valor numérico de uma constante
+int constantValue(SymbolNode* sym) {
+  if (!sym) return 0;
+
+  if (sym->type == SYMBOL_LIT_INT) {
+    return atoi(sym->text.c_str());
+  }
+  if (sym->type == SYMBOL_LIT_CHAR) {
+    // 'c' ou sequência de escape '\n'
+    if (sym->text.length() >= 4 && sym->text[1] == '\\') {
+      switch (sym->text[2]) {
+        case 'n':  return '\n';
+        case 't':  return '\t';
+        case 'r':  return '\r';
+        case '0':  return '\0';
+        default:   return sym->text[2];
+      }
+    }
+    return sym->text.length() >= 3 ? (int)sym->text[1] : 0;
+  }
+  if (sym->type == SYMBOL_LIT_BOOL) {
+    return sym->text == "true" ? 1 : 0;
+  }
+  return 0;
+}
+
+// Função para internar uma constante inteira
+SymbolNode* makeIntConstant(int value) {
+  std::lock_guard<std::mutex> lock(constantMutex);
+  return symbolTable->insertLiteral(std::to_string(value), SYMBOL_LIT_INT);
+}
+
+// Função para internar uma constante booleana
+SymbolNode* makeBoolConstant(bool value) {
+  std::lock_guard<std::mutex> lock(constantMutex);
+  return symbolTable->insertLiteral(value ? "true" : "false", SYMBOL_LIT_BOOL);
+}
@@ -8,8 +8,10 @@
 #ifndef SYMBOLS_HPP
 #define SYMBOLS_HPP
 
-#include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // Definições dos tipos de símbolos na tabela (literais)
 #define SYMBOL_LIT_INT 1
@@ -18,6 +20,8 @@
 #define SYMBOL_LIT_BOOL 4
 #define SYMBOL_LIT_STRING 5
 #define SYMBOL_IDENTIFIER 7
+#define SYMBOL_TEMP 8     // Temporário gerado (fora da tabela hash)
+#define SYMBOL_LABEL 9    // Label gerado (fora da tabela hash)
 
 // Natureza dos identificadores (para verificação semântica)
 #define NATURE_SCALAR 1
@@ -40,15 +44,52 @@ struct SymbolNode {
   int nature;       // Natureza: escalar, vetor, função (0 = não definido)
   int dataType;     // Tipo de dado: int, char, float, bool (0 = não definido)
   ASTNode* parameterList; // Lista de parâmetros (apenas para funções)
+  int vectorSize;   // Número de elementos (apenas para vetores)
+  unsigned hash;    // Hash do lexema (calculado uma única vez, na inserção)
+  int id;           // Número do temporário/label (-1 para símbolos do programa)
+  SymbolNode* owner; // Função em que o temporário/label foi criado (ou nulo)
 
-  SymbolNode() : type(0), text(""), nature(0), dataType(0), parameterList(nullptr) {}
-  SymbolNode(int t, const std::string &txt) : type(t), text(txt), nature(0), dataType(0), parameterList(nullptr) {}
+  SymbolNode() : type(0), text(""), nature(0), dataType(0), parameterList(nullptr), vectorSize(0), hash(0), id(-1), owner(nullptr) {}
+  SymbolNode(int t, const std::string &txt) : type(t), text(txt), nature(0), dataType(0), parameterList(nullptr), vectorSize(0), hash(0), id(-1), owner(nullptr) {}
 };
 
 // Classe para gerenciar a tabela de símbolos
+// Tabela hash com endereçamento aberto (sondagem linear): cada lexema é
+// internado uma única vez e os nodos ficam em blocos contíguos (arena), com
+// endereços estáveis durante toda a compilação
 class SymbolTable {
 private:
-  std::map<std::string, SymbolNode *> table;
+  static const size_t BLOCK_NODES = 1024; // Nodos por bloco da arena
+
+  std::vector<SymbolNode *> slots;  // Slots da tabela hash (potência de 2)
+  size_t count;                     // Número de símbolos inseridos
+
+  std::vector<SymbolNode *> blocks; // Blocos da arena de nodos
+  size_t blockUsed;                 // Nodos usados no último bloco
+
+  // Literais criados pelo compilador sem literal igual no programa (ver
+  // insertLiteral), por tipo e texto; os nodos ficam na arena principal
+  std::unordered_map<std::string, SymbolNode *> literals;
+
+  std::vector<SymbolNode *> generatedBlocks; // Blocos de temporários e labels
+  size_t generatedUsed;                      // Nodos usados no último deles
+  std::mutex generatedMutex;                 // Funções traduzidas em paralelo
+
+  // Hash FNV-1a de um lexema
+  static unsigned hashLexeme(const char *lexeme, size_t length);
+
+  // Encontra o slot do lexema (ocupado por ele ou o primeiro vazio)
+  size_t findSlot(const char *lexeme, size_t length, unsigned hash) const;
+
+  // Dobra a capacidade da tabela e reinsere os símbolos
+  void grow();
+
+  // Aloca um nodo na arena dada (blocos e nodos usados no último bloco)
+  static SymbolNode *allocateNode(std::vector<SymbolNode *> &arena, size_t &used,
+                                  int type, const char *lexeme, size_t length);
+
+  // Destrói os nodos de uma arena e devolve seus blocos
+  static void releaseNodes(std::vector<SymbolNode *> &arena, size_t &used);
 
 public:
   SymbolTable();
@@ -56,9 +97,26 @@ public:
 
   // Inserir um símbolo na tabela
   SymbolNode *insert(const std::string &lexeme, int type);
+  SymbolNode *insert(const char *lexeme, size_t length, int type);
+
+  // Internar um literal criado pelo compilador (dobra de constantes):
+  // reaproveita o literal do programa de mesmo texto e tipo, mas nunca um
+  // identificador de mesmo lexema (o scanner aceita nomes como -1), e não
+  // entra na tabela hash, para não mudar o que o scanner encontra depois
+  SymbolNode *insertLiteral(const std::string &lexeme, int type);
+
+  // Criar temporário ou label: o nodo vem de uma arena própria e não é
+  // internado na tabela hash nem listado (sem lexema até ser impresso);
+  // pode ser chamada por várias threads ao mesmo tempo
+  SymbolNode *createGenerated(int type, int id, SymbolNode *owner);
+
+  // Liberar todos os temporários e labels criados até agora (compilação em
+  // fluxo, após emitir cada função)
+  void releaseGenerated();
 
   // Buscar um símbolo na tabela
   SymbolNode *lookup(const std::string &lexeme);
+  SymbolNode *lookup(const char *lexeme, size_t length);
 
   // Limpar a tabela
   void clear();
@@ -66,6 +124,12 @@ public:
   // Verificar se um símbolo existe
   bool exists(const std::string &lexeme);
 
+  // Número de símbolos na tabela
+  size_t size() const { return count; }
+
+  // Símbolos ordenados por lexema (ordem determinística, para impressão)
+  std::vector<SymbolNode *> sortedSymbols() const;
+
   // Imprimir a tabela de símbolos
   void printTable();
 
@@ -88,10 +152,37 @@ void initSymbolTable();
 // Função para finalizar a tabela de símbolos
 void finalizeSymbolTable();
 
-// Função para criar símbolo temporário (para geração de código TAC)
-SymbolNode* makeTemp();
+// Função para começar a tradução de uma função: os temporários e labels
+// criados a seguir nesta thread são numerados a partir de zero e levam o
+// nome da função (as funções são traduzidas em paralelo)
+void beginFunctionSymbols(SymbolNode* function);
+
+// Função para criar símbolo temporário (para geração de código TAC) com o
+// tipo de dado do valor que ele guarda
+SymbolNode* makeTemp(int dataType = 0);
 
 // Função para criar label (para geração de código TAC)
 SymbolNode* makeLabel();
 
+// Número de temporários e labels criados até agora na função em tradução
+// nesta thread (ids densos 0..n-1)
+int tempCount();
+int labelCount();
+
+// Nome do símbolo para impressão: temporários e labels recebem o nome
+// (__<função>_tempN/__<função>_labelN, ou __tempN/__labelN fora de uma
+// função) apenas na primeira vez que são impressos
+const std::string& symbolName(SymbolNode* sym);
+
+// Verificar se o símbolo é uma constante (literal inteiro, char ou booleano)
+bool isConstant(SymbolNode* sym);
+
+// Valor numérico de uma constante (char pelo código, booleano como 0/1)
+int constantValue(SymbolNode* sym);
+
+// Internar constantes calculadas em tempo de compilação como literais (com
+// trava: são chamadas pelas threads que traduzem e otimizam as funções)
+SymbolNode* makeIntConstant(int value);
+SymbolNode* makeBoolConstant(bool value);
+
 #endif // SYMBOLS_HPP
\ No newline at end of file
@@ -6,6 +6,7 @@
  */
 
 #include "tac.hpp"
+#include <climits>
 #include <iostream>
 #include <cstdio>
 #include <vector>
@@ -22,28 +23,19 @@ TAC* tacCreate(int type, SymbolNode* res, SymbolNode* op1, SymbolNode* op2) {
     return newTac;
 }
 
-// Unir duas listas de TACs (lista invertida)
-// Retorna ponteiro para o último TAC da lista resultante
-TAC* tacJoin(TAC* tac1, TAC* tac2) {
-    if (!tac1) return tac2;
-    if (!tac2) return tac1;
-
-    // tac1 é o último da primeira lista (executado por último na lista 1)
-    // tac2 é o último da segunda lista (executado por último na lista 2)
-    // Queremos: primeiro(tac1) -> ... -> tac1 -> primeiro(tac2) -> ... -> tac2
-    // Ou seja, tac2 vem DEPOIS de tac1 na ordem de execução
-
-    // Encontrar o primeiro da segunda lista
-    TAC* first2 = tac2;
-    while (first2->prev) {
-        first2 = first2->prev;
-    }
+// Unir dois fragmentos de TACs: code2 é executado depois de code1
+TACCode tacJoin(TACCode code1, TACCode code2) {
+    if (code1.empty()) return code2;
+    if (code2.empty()) return code1;
 
-    // Conectar o primeiro da segunda lista ao último da primeira
-    first2->prev = tac1;
+    // Ligar a última instrução do primeiro à primeira do segundo
+    code1.last->next = code2.first;
+    code2.first->prev = code1.last;
 
-    // Retornar o último da segunda lista (que agora é o último de tudo)
-    return tac2;
+    TACCode result;
+    result.first = code1.first;
+    result.last = code2.last;
+    return result;
 }
 
 // Obter nome do tipo de TAC
@@ -70,6 +62,13 @@ const char* tacTypeName(int type) {
         case TAC_BEGINFUN:   return "TAC_BEGINFUN";
         case TAC_ENDFUN:     return "TAC_ENDFUN";
         case TAC_IFZ:        return "TAC_IFZ";
+        case TAC_IFNZ:       return "TAC_IFNZ";
+        case TAC_JLT:        return "TAC_JLT";
+        case TAC_JGT:        return "TAC_JGT";
+        case TAC_JLE:        return "TAC_JLE";
+        case TAC_JGE:        return "TAC_JGE";
+        case TAC_JEQ:        return "TAC_JEQ";
+        case TAC_JNE:        return "TAC_JNE";
         case TAC_JUMP:       return "TAC_JUMP";
         case TAC_CALL:       return "TAC_CALL";
         case TAC_ARG:        return "TAC_ARG";
@@ -83,6 +82,173 @@ const char* tacTypeName(int type) {
     }
 }
 
+// Verificar se a instrução é um desvio
+bool tacIsJump(TAC* tac) {
+    if (!tac) return false;
+
+    switch(tac->type) {
+        case TAC_JUMP: case TAC_IFZ: case TAC_IFNZ:
+        case TAC_JLT: case TAC_JGT: case TAC_JLE: case TAC_JGE: case TAC_JEQ: case TAC_JNE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Desvio com comparação correspondente a uma comparação (opcionalmente negada)
+int tacCompareJump(int compareType, bool negate) {
+    switch(compareType) {
+        case TAC_LT:  return negate ? TAC_JGE : TAC_JLT;
+        case TAC_GT:  return negate ? TAC_JLE : TAC_JGT;
+        case TAC_LE:  return negate ? TAC_JGT : TAC_JLE;
+        case TAC_GE:  return negate ? TAC_JLT : TAC_JGE;
+        case TAC_EQ:  return negate ? TAC_JNE : TAC_JEQ;
+        case TAC_DIF: return negate ? TAC_JEQ : TAC_JNE;
+        default:      return 0;
+    }
+}
+
+// Símbolo escrito pela instrução
+SymbolNode* tacDefinition(TAC* tac) {
+    if (!tac) return nullptr;
+
+    switch(tac->type) {
+        case TAC_MOVE:
+        case TAC_ADD: case TAC_SUB: case TAC_MUL: case TAC_DIV: case TAC_MOD:
+        case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+        case TAC_AND: case TAC_OR: case TAC_NOT: case TAC_NEG:
+        case TAC_CALL:
+        case TAC_READ:
+        case TAC_VEC_ACCESS:
+            return tac->res;
+        default:
+            // VEC_WRITE/VEC_READ escrevem em um elemento de vetor, não no símbolo
+            return nullptr;
+    }
+}
+
+// Campos com os símbolos lidos pela instrução
+int tacUseFields(TAC* tac, SymbolNode** fields[2]) {
+    int count = 0;
+    if (!tac) return 0;
+
+    switch(tac->type) {
+        case TAC_ADD: case TAC_SUB: case TAC_MUL: case TAC_DIV: case TAC_MOD:
+        case TAC_LT: case TAC_GT: case TAC_LE: case TAC_GE: case TAC_EQ: case TAC_DIF:
+        case TAC_AND: case TAC_OR:
+        case TAC_VEC_WRITE:
+        case TAC_JLT: case TAC_JGT: case TAC_JLE: case TAC_JGE: case TAC_JEQ: case TAC_JNE:
+            if (tac->op1) fields[count++] = &tac->op1;
+            if (tac->op2) fields[count++] = &tac->op2;
+            break;
+        case TAC_MOVE:
+        case TAC_NOT: case TAC_NEG:
+        case TAC_IFZ: case TAC_IFNZ:
+        case TAC_RET:
+        case TAC_PRINT:
+        case TAC_VEC_READ:
+            if (tac->op1) fields[count++] = &tac->op1;
+            break;
+        case TAC_VEC_ACCESS:
+            // op1 é o vetor, op2 o índice
+            if (tac->op2) fields[count++] = &tac->op2;
+            break;
+        case TAC_ARG:
+            // O valor do argumento fica em res
+            if (tac->res) fields[count++] = &tac->res;
+            break;
+        default:
+            break;
+    }
+    return count;
+}
+
+// Símbolos lidos pela instrução
+int tacUses(TAC* tac, SymbolNode* uses[2]) {
+    SymbolNode** fields[2];
+    int count = tacUseFields(tac, fields);
+    for (int i = 0; i < count; i++) uses[i] = *fields[i];
+    return count;
+}
+
+// Avaliar uma operação entre constantes com a aritmética de 32 bits do
+// código gerado
+bool tacFoldBinary(int type, int a, int b, int& value) {
+    unsigned ua = (unsigned)a;
+    unsigned ub = (unsigned)b;
+
+    switch(type) {
+        case TAC_ADD: value = (int)(ua + ub); return true;
+        case TAC_SUB: value = (int)(ua - ub); return true;
+        case TAC_MUL: value = (int)(ua * ub); return true;
+        case TAC_DIV:
+        case TAC_MOD:
+            if (b == 0 || (a == INT_MIN && b == -1)) return false;
+            value = (type == TAC_DIV) ? a / b : a % b;
+            return true;
+        case TAC_LT:  value = a < b;  return true;
+        case TAC_GT:  value = a > b;  return true;
+        case TAC_LE:  value = a <= b; return true;
+        case TAC_GE:  value = a >= b; return true;
+        case TAC_EQ:  value = a == b; return true;
+        case TAC_DIF: value = a != b; return true;
+        case TAC_AND: value = a & b;  return true;
+        case TAC_OR:  value = a | b;  return true;
+        default:      return false;
+    }
+}
+
+// Simplificar identidades algébricas com os operandos de uma operação
+SymbolNode* tacSimplifyBinary(int type, SymbolNode* left, SymbolNode* right) {
+    bool leftConst = isConstant(left);
+    bool rightConst = isConstant(right);
+    int leftValue = leftConst ? constantValue(left) : 0;
+    int rightValue = rightConst ? constantValue(right) : 0;
+    bool same = (left == right) && !leftConst;
+
+    switch (type) {
+        case TAC_ADD:
+            if (rightConst && rightValue == 0) return left;
+            if (leftConst && leftValue == 0) return right;
+            break;
+        case TAC_SUB:
+            if (rightConst && rightValue == 0) return left;
+            if (same) return makeIntConstant(0);
+            break;
+        case TAC_MUL:
+            if (rightConst && rightValue == 1) return left;
+            if (leftConst && leftValue == 1) return right;
+            if ((rightConst && rightValue == 0) || (leftConst && leftValue == 0)) return makeIntConstant(0);
+            break;
+        case TAC_DIV:
+            if (rightConst && rightValue == 1) return left;
+            break;
+        case TAC_MOD:
+            // x % -1 fica: com x = INT_MIN a divisão estoura na execução
+            if (rightConst && rightValue == 1) return makeIntConstant(0);
+            break;
+        case TAC_EQ: case TAC_LE: case TAC_GE:
+            if (same) return makeBoolConstant(true);
+            break;
+        case TAC_DIF: case TAC_LT: case TAC_GT:
+            if (same) return makeBoolConstant(false);
+            break;
+        case TAC_AND:
+            // x & true = x, x & false = false
+            if (rightConst) return rightValue ? left : right;
+            if (leftConst) return leftValue ? right : left;
+            if (same) return left;
+            break;
+        case TAC_OR:
+            // x | false = x, x | true = true
+            if (rightConst) return rightValue ? right : left;
+            if (leftConst) return leftValue ? left : right;
+            if (same) return left;
+            break;
+    }
+    return nullptr;
+}
+
 // Imprimir uma instrução TAC
 void tacPrintSingle(TAC* tac) {
     if (!tac) return;
@@ -93,17 +259,17 @@ void tacPrintSingle(TAC* tac) {
     fprintf(stderr, "TAC(%-14s", tacTypeName(tac->type));
 
     if (tac->res)
-        fprintf(stderr, ", %s", tac->res->text.c_str());
+        fprintf(stderr, ", %s", symbolName(tac->res).c_str());
     else
         fprintf(stderr, ", NULL");
 
     if (tac->op1)
-        fprintf(stderr, ", %s", tac->op1->text.c_str());
+        fprintf(stderr, ", %s", symbolName(tac->op1).c_str());
     else
         fprintf(stderr, ", NULL");
 
     if (tac->op2)
-        fprintf(stderr, ", %s", tac->op2->text.c_str());
+        fprintf(stderr, ", %s", symbolName(tac->op2).c_str());
     else
         fprintf(stderr, ", NULL");
 
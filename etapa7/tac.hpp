@@ -41,6 +41,13 @@
 #define TAC_VEC_READ    28  // Leitura de vetor: res[op1] = input
 #define TAC_VEC_WRITE   29  // Escrita em vetor: res[op1] = op2
 #define TAC_VEC_ACCESS  30  // Acesso a vetor: res = op1[op2]
+#define TAC_IFNZ        31  // Desvio condicional: if op1 != 0 goto res
+#define TAC_JLT         32  // Comparação e desvio: if op1 < op2 goto res
+#define TAC_JGT         33  // Comparação e desvio: if op1 > op2 goto res
+#define TAC_JLE         34  // Comparação e desvio: if op1 <= op2 goto res
+#define TAC_JGE         35  // Comparação e desvio: if op1 >= op2 goto res
+#define TAC_JEQ         36  // Comparação e desvio: if op1 == op2 goto res
+#define TAC_JNE         37  // Comparação e desvio: if op1 != op2 goto res
 
 // Estrutura de um TAC (Three Address Code)
 struct TAC {
@@ -48,20 +55,35 @@ struct TAC {
     SymbolNode* res;        // Resultado (endereço)
     SymbolNode* op1;        // Operando 1 (endereço)
     SymbolNode* op2;        // Operando 2 (endereço)
-    struct TAC* prev;       // Ponteiro para instrução anterior (lista invertida)
-    struct TAC* next;       // Ponteiro para próxima instrução (lista normal)
+    struct TAC* prev;       // Ponteiro para instrução anterior
+    struct TAC* next;       // Ponteiro para próxima instrução
 
     TAC() : type(0), res(nullptr), op1(nullptr), op2(nullptr), prev(nullptr), next(nullptr) {}
 };
 
+// Fragmento de código TAC: guarda a primeira e a última instrução de uma
+// sequência já encadeada (prev e next), permitindo concatenação em O(1)
+struct TACCode {
+    TAC* first;             // Primeira instrução do fragmento (ordem de execução)
+    TAC* last;              // Última instrução do fragmento
+
+    TACCode() : first(nullptr), last(nullptr) {}
+    TACCode(TAC* tac) : first(tac), last(tac) {}
+
+    bool empty() const { return last == nullptr; }
+
+    // Símbolo com o resultado do fragmento (resultado da última instrução)
+    SymbolNode* res() const { return last ? last->res : nullptr; }
+};
+
 // Funções para manipulação de TACs
 
 // Criar um novo TAC
 TAC* tacCreate(int type, SymbolNode* res, SymbolNode* op1, SymbolNode* op2);
 
-// Unir duas listas de TACs (lista invertida)
-// Retorna ponteiro para o último TAC da lista resultante
-TAC* tacJoin(TAC* tac1, TAC* tac2);
+// Unir dois fragmentos de TACs: code2 é executado depois de code1
+// Apenas religa as pontas dos fragmentos - custo constante
+TACCode tacJoin(TACCode code1, TACCode code2);
 
 // Imprimir uma instrução TAC
 void tacPrintSingle(TAC* tac);
@@ -81,4 +103,35 @@ void tacFree(TAC* first);
 // Obter nome do tipo de TAC
 const char* tacTypeName(int type);
 
+// Verificar se a instrução é um desvio (incondicional ou condicional) -
+// o label de destino fica em res
+bool tacIsJump(TAC* tac);
+
+// Desvio com comparação equivalente a uma comparação TAC_LT..TAC_DIF,
+// ou com a condição negada (TAC_LT -> TAC_JGE, ...)
+int tacCompareJump(int compareType, bool negate);
+
+// Símbolo escrito pela instrução (nullptr se não escreve nenhum escalar)
+SymbolNode* tacDefinition(TAC* tac);
+
+// Símbolos lidos pela instrução (operandos de valor, sem labels, funções
+// ou vetores); retorna a quantidade preenchida em uses (no máximo 2)
+int tacUses(TAC* tac, SymbolNode* uses[2]);
+
+// Como tacUses, mas devolve os endereços dos campos (res, op1 ou op2) que
+// guardam os símbolos lidos, para que possam ser substituídos
+int tacUseFields(TAC* tac, SymbolNode** fields[2]);
+
+// Avaliar em tempo de compilação uma operação binária (TAC_ADD..TAC_OR)
+// entre constantes, com a aritmética de 32 bits do código gerado
+// Retorna false quando o resultado depende da execução (divisão por zero)
+bool tacFoldBinary(int type, int a, int b, int& value);
+
+// Simplificar identidades algébricas (x+0, x*1, x*0, x-x, x&true, ...) de
+// uma operação binária (TAC_ADD..TAC_OR) sobre os símbolos left e right
+// Retorna o símbolo equivalente à operação, ou nullptr se não há
+// simplificação. Os operandos já foram avaliados, então descartar um deles
+// não perde efeitos (e nenhuma divisão que pode falhar é descartada)
+SymbolNode* tacSimplifyBinary(int type, SymbolNode* left, SymbolNode* right);
+
 #endif // TAC_HPP
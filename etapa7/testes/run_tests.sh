@@ -0,0 +1,90 @@
+#!/bin/sh
+#
+# Compiladores - etapa7 - testes/run_tests.sh - semestre 2025/2
+# Autor: Santiago Gonzaga
+#
+# Testes de regressão: executa cada programa na máquina virtual (--interp)
+# em cada nível de otimização e compara a saída padrão com o arquivo
+# .esperado ao lado do programa. A entrada padrão vem do arquivo .entrada
+# ao lado do programa, se existir (senão fica vazia). Programas sem
+# .esperado são ignorados. Em Linux x86-64 também monta e executa o
+# assembly gerado (modo --asm)
+#
+# Uso: sh testes/run_tests.sh [-O "niveis"] [-m "modos"] [programa...]
+#   niveis = opções de otimização (padrao: "-O0 -O1 -O2")
+#   modos = opções de execução (padrao: --interp, mais --asm em Linux
+#           x86-64; --run usa o JIT; --asm gera assembly x86-64 e o monta
+#           com $CC)
+#   programa = arquivos .txt (padrao: testes/*.txt bench/programas/*.txt)
+#
+# Variáveis de ambiente: ETAPA7 (compilador, padrao ./etapa7), CC
+# (montador/ligador do modo --asm, padrao gcc)
+
+ETAPA7=${ETAPA7:-./etapa7}
+CC=${CC:-gcc}
+LEVELS="-O0 -O1 -O2"
+MODES="--interp"
+[ "$(uname -sm)" = "Linux x86_64" ] && MODES="--interp --asm"
+
+# No modo --asm, uma divisão que falha mata o programa (SIGFPE) onde a
+# máquina virtual para com erro; com a saída por linha, o que foi impresso
+# antes não se perde no buffer do stdio. O ':' depois do programa faz o
+# subshell esperar por ele, e o aviso do sinal vai para erros.txt
+STDBUF=
+command -v stdbuf > /dev/null 2>&1 && STDBUF="stdbuf -oL"
+
+while getopts "O:m:" opt; do
+    case $opt in
+        O) LEVELS=$OPTARG ;;
+        m) MODES=$OPTARG ;;
+        *) sed -n 's/^# Uso: //p' "$0" >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+PROGRAMS=${*:-"testes/*.txt bench/programas/*.txt"}
+
+if [ ! -x "$ETAPA7" ]; then
+    echo "Erro: compile antes com 'make etapa7'" >&2
+    exit 1
+fi
+
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/etapa7-testes.XXXXXX")
+trap 'rm -rf "$WORK"' EXIT
+
+total=0
+failures=0
+# shellcheck disable=SC2086
+for program in $PROGRAMS; do
+    expected=${program%.txt}.esperado
+    [ -f "$expected" ] || continue
+    input=${program%.txt}.entrada
+    [ -f "$input" ] || input=/dev/null
+
+    for mode in $MODES; do
+        for level in $LEVELS; do
+            total=$((total + 1))
+            # O código de saída é o valor devolvido por main (ou 5 em erro
+            # de execução, que alguns testes provocam de propósito)
+            if [ "$mode" = "--asm" ]; then
+                : > "$WORK/saida.txt"
+                if "$ETAPA7" --target=x86-64 "$level" "$program" "$WORK/programa.s" \
+                        > /dev/null 2> "$WORK/erros.txt" &&
+                    "$CC" -o "$WORK/programa" "$WORK/programa.s" 2>> "$WORK/erros.txt"; then
+                    ($STDBUF "$WORK/programa" < "$input" > "$WORK/saida.txt"; :) 2>> "$WORK/erros.txt"
+                fi
+            else
+                "$ETAPA7" "$mode" "$level" "$program" < "$input" > "$WORK/saida.txt" 2> "$WORK/erros.txt"
+            fi
+            if ! cmp -s "$expected" "$WORK/saida.txt"; then
+                failures=$((failures + 1))
+                echo "FALHOU: $program ($mode $level)"
+                diff "$expected" "$WORK/saida.txt" | head -10
+                head -5 "$WORK/erros.txt"
+            fi
+        done
+    done
+done
+
+echo "$total execucoes, $failures falhas"
+[ "$failures" -eq 0 ]
@@ -0,0 +1,119 @@
+/*
+ * Compiladores - etapa7 - threadpool.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação do pool de threads com roubo de tarefas
+ */
+
+#include "threadpool.hpp"
+
+ThreadPool::ThreadPool(int threads) : generation(0), stopping(false), task(nullptr), pending(0) {
+    if (threads < 1) threads = 1;
+
+    for (int i = 0; i < threads; i++) {
+        queues.push_back(new WorkQueue());
+    }
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, (size_t)i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (WorkQueue* queue : queues) {
+        delete queue;
+    }
+}
+
+bool ThreadPool::takeTask(size_t participant, size_t& index) {
+    // Própria fila: do fim
+    {
+        WorkQueue* own = queues[participant];
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->tasks.empty()) {
+            index = own->tasks.back();
+            own->tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Roubo: do início das filas dos outros participantes
+    for (size_t i = 1; i < queues.size(); i++) {
+        WorkQueue* victim = queues[(participant + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty()) {
+            index = victim->tasks.front();
+            victim->tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTasks(size_t participant) {
+    size_t index;
+    while (takeTask(participant, index)) {
+        (*task)(index);
+        if (pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop(size_t participant) {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runTasks(participant);
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    // Sem threads extras (ou uma tarefa só): executa na própria thread
+    if (workers.empty() || count < 2) {
+        for (size_t i = 0; i < count; i++) body(i);
+        return;
+    }
+
+    // Faixas contíguas por participante; a tarefa é publicada antes das
+    // filas, e os mutexes das filas a tornam visível a quem retirar um índice
+    task = &body;
+    pending.store(count);
+    size_t participants = queues.size();
+    for (size_t p = 0; p < participants; p++) {
+        std::lock_guard<std::mutex> lock(queues[p]->mutex);
+        for (size_t i = count * p / participants; i < count * (p + 1) / participants; i++) {
+            queues[p]->tasks.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+    }
+    wake.notify_all();
+
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending.load() == 0; });
+    task = nullptr;
+}
+
+int defaultThreadCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 0 ? (int)cores : 1;
+}
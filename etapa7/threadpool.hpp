@@ -0,0 +1,72 @@
+/*
+ * Compiladores - etapa7 - threadpool.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições do pool de threads com roubo de tarefas (work stealing) usado
+ * para processar as funções do programa em paralelo
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads: cada participante (a thread que chama parallelFor é o
+// participante 0) tem sua própria fila de tarefas. O dono consome do fim da
+// fila; quem fica sem trabalho rouba do início da fila dos outros, o que
+// equilibra funções de tamanhos muito diferentes
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<WorkQueue*> queues;      // Uma fila por participante
+
+    std::mutex mutex;                    // Protege generation e stopping
+    std::condition_variable wake;        // Sinaliza novo lote (ou término)
+    std::condition_variable done;        // Sinaliza lote concluído
+    unsigned long generation;            // Número do lote atual
+    bool stopping;
+
+    const std::function<void(size_t)>* task;  // Tarefa do lote atual
+    std::atomic<size_t> pending;              // Tarefas ainda não concluídas
+
+    // Retira uma tarefa da própria fila ou rouba de outra
+    bool takeTask(size_t participant, size_t& index);
+
+    // Executa tarefas até não restar nenhuma nas filas
+    void runTasks(size_t participant);
+
+    void workerLoop(size_t participant);
+
+public:
+    // threads = número total de participantes (1 = sem threads extras)
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    // Executa task(i) para cada i em [0, count), em qualquer ordem, e
+    // retorna quando todas terminarem
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    // Número de participantes
+    int size() const { return (int)queues.size(); }
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+// Número de threads padrão (núcleos disponíveis, ao menos 1)
+int defaultThreadCount();
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,239 @@
+/*
+ * Compiladores - etapa7 - timing.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação da medição das fases do compilador. As alocações são
+ * contadas substituindo o operator new/delete global, então cobrem AST,
+ * tabela de símbolos, TAC e contêineres da STL (não cobrem malloc direto),
+ * a partir de timingEnable
+ */
+
+#include "timing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// Contadores de alocação por thread: cada thread pega uma faixa na primeira
+// alocação e só ela escreve ali (faixas em linhas de cache distintas, sem
+// disputa com --jobs); sampleResources soma as faixas. Com mais threads que
+// faixas, as excedentes dividem faixas, por isso o incremento é atômico
+#define ALLOCATION_SLOTS    64
+
+struct alignas(64) AllocationSlot {
+    std::atomic<unsigned long> count;
+    std::atomic<unsigned long> bytes;
+};
+
+static AllocationSlot allocationSlots[ALLOCATION_SLOTS];
+static std::atomic<unsigned> nextAllocationSlot(0);
+static thread_local int allocationSlot = -1;
+
+// Só conta depois de timingEnable; antes disso operator new é só malloc
+static std::atomic<bool> countAllocations(false);
+
+void* operator new(std::size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        if (allocationSlot < 0) {
+            allocationSlot = (int)(nextAllocationSlot.fetch_add(1, std::memory_order_relaxed) %
+                                   ALLOCATION_SLOTS);
+        }
+        AllocationSlot& slot = allocationSlots[allocationSlot];
+        slot.count.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+// Amostra dos recursos do processo em um instante
+struct ResourceSample {
+    double wallUs;              // Microssegundos desde timingEnable
+    double cpuUs;               // Tempo de CPU (usuário + sistema) do processo
+    long peakRssKb;             // Pico de memória residente até o instante
+    unsigned long allocations;  // Alocações feitas até o instante
+    unsigned long bytes;        // Bytes alocados até o instante
+};
+
+// Fase encerrada
+struct PhaseRecord {
+    std::string name;
+    int depth;                  // Nível de aninhamento (0 = fase principal)
+    ResourceSample start;
+    ResourceSample end;
+};
+
+static bool enabled = false;
+static bool reportAtExit = false;
+static std::string traceName;
+static std::chrono::steady_clock::time_point origin;
+static std::vector<PhaseRecord> openPhases;
+static std::vector<PhaseRecord> phases;
+
+static ResourceSample sampleResources() {
+    ResourceSample sample;
+    sample.wallUs = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - origin).count();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    sample.cpuUs = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 +
+                   usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#ifdef __APPLE__
+    sample.peakRssKb = usage.ru_maxrss / 1024;  // macOS informa em bytes
+#else
+    sample.peakRssKb = usage.ru_maxrss;         // Linux informa em KB
+#endif
+
+    sample.allocations = 0;
+    sample.bytes = 0;
+    for (const AllocationSlot& slot : allocationSlots) {
+        sample.allocations += slot.count.load(std::memory_order_relaxed);
+        sample.bytes += slot.bytes.load(std::memory_order_relaxed);
+    }
+    return sample;
+}
+
+// Encerra as fases ainda abertas e emite o relatório e o trace pedidos
+static void timingFinish() {
+    while (!openPhases.empty()) timingEnd();
+
+    if (reportAtExit) timingPrintReport(stderr);
+    if (!traceName.empty() && !timingWriteTrace(traceName.c_str())) {
+        fprintf(stderr, "Erro: nao foi possivel escrever o trace em %s\n", traceName.c_str());
+    }
+}
+
+void timingEnable(bool report, const char* traceFile) {
+    if (enabled) return;
+    enabled = true;
+    reportAtExit = report;
+    if (traceFile) traceName = traceFile;
+    origin = std::chrono::steady_clock::now();
+    countAllocations.store(true, std::memory_order_relaxed);
+    atexit(timingFinish);
+}
+
+bool timingEnabled() {
+    return enabled;
+}
+
+void timingBegin(const char* name) {
+    if (!enabled) return;
+
+    PhaseRecord phase;
+    phase.name = name;
+    phase.depth = (int)openPhases.size();
+    phase.start = sampleResources();
+    openPhases.push_back(phase);
+}
+
+void timingEnd() {
+    if (!enabled || openPhases.empty()) return;
+
+    PhaseRecord phase = openPhases.back();
+    openPhases.pop_back();
+    phase.end = sampleResources();
+    phases.push_back(phase);
+}
+
+void timingPrintReport(FILE* output) {
+    if (!output) return;
+
+    fprintf(output, "\n===== Relatorio de tempo por fase =====\n");
+    fprintf(output, "%-36s %11s %11s %13s %11s %14s\n",
+            "Fase", "Parede(ms)", "CPU(ms)", "Pico RSS(KB)", "Alocacoes", "Bytes");
+
+    // As fases são registradas ao encerrar; a ordem de início é a de exibição
+    std::vector<const PhaseRecord*> ordered;
+    for (const PhaseRecord& phase : phases) ordered.push_back(&phase);
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const PhaseRecord* a, const PhaseRecord* b) {
+                         return a->start.wallUs < b->start.wallUs;
+                     });
+
+    double totalWall = 0, totalCpu = 0;
+    unsigned long totalAllocations = 0, totalBytes = 0;
+    for (const PhaseRecord* phase : ordered) {
+        double wall = (phase->end.wallUs - phase->start.wallUs) / 1000.0;
+        double cpu = (phase->end.cpuUs - phase->start.cpuUs) / 1000.0;
+        unsigned long allocations = phase->end.allocations - phase->start.allocations;
+        unsigned long bytes = phase->end.bytes - phase->start.bytes;
+
+        std::string label = std::string(2 * phase->depth, ' ') + phase->name;
+        fprintf(output, "%-36s %11.3f %11.3f %13ld %11lu %14lu\n", label.c_str(),
+                wall, cpu, phase->end.peakRssKb, allocations, bytes);
+
+        if (phase->depth == 0) {
+            totalWall += wall;
+            totalCpu += cpu;
+            totalAllocations += allocations;
+            totalBytes += bytes;
+        }
+    }
+
+    ResourceSample now = sampleResources();
+    fprintf(output, "%-36s %11.3f %11.3f %13ld %11lu %14lu\n", "Total (fases principais)",
+            totalWall, totalCpu, now.peakRssKb, totalAllocations, totalBytes);
+}
+
+// Escreve uma string JSON com os escapes necessários
+static void writeJsonString(FILE* output, const std::string& text) {
+    fputc('"', output);
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', output);
+            fputc(c, output);
+        } else if ((unsigned char)c < 0x20) {
+            fprintf(output, "\\u%04x", c);
+        } else {
+            fputc(c, output);
+        }
+    }
+    fputc('"', output);
+}
+
+bool timingWriteTrace(const char* fileName) {
+    FILE* output = fopen(fileName, "w");
+    if (!output) return false;
+
+    // Eventos completos ("X") por fase e um contador ("C") com o pico de RSS
+    fprintf(output, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(output, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+                    "\"args\":{\"name\":\"etapa7\"}}");
+    for (const PhaseRecord& phase : phases) {
+        fprintf(output, ",\n{\"name\":");
+        writeJsonString(output, phase.name);
+        fprintf(output, ",\"cat\":\"fase\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                        "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"cpu_ms\":%.3f,"
+                        "\"peak_rss_kb\":%ld,\"allocations\":%lu,\"bytes\":%lu}}",
+                phase.start.wallUs, phase.end.wallUs - phase.start.wallUs,
+                (phase.end.cpuUs - phase.start.cpuUs) / 1000.0, phase.end.peakRssKb,
+                phase.end.allocations - phase.start.allocations,
+                phase.end.bytes - phase.start.bytes);
+        fprintf(output, ",\n{\"name\":\"pico RSS (KB)\",\"ph\":\"C\",\"pid\":1,\"tid\":1,"
+                        "\"ts\":%.3f,\"args\":{\"rss\":%ld}}",
+                phase.end.wallUs, phase.end.peakRssKb);
+    }
+    fprintf(output, "\n]}\n");
+
+    fclose(output);
+    return true;
+}
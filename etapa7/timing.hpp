@@ -0,0 +1,45 @@
+/*
+ * Compiladores - etapa7 - timing.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições para medição das fases do compilador (tempo de parede, tempo de
+ * CPU, pico de memória e alocações) com relatório no estilo -ftime-report e
+ * exportação no formato trace-event (chrome://tracing, Perfetto)
+ */
+
+#ifndef TIMING_HPP
+#define TIMING_HPP
+
+#include <cstdio>
+
+// Habilita a medição; report imprime o relatório em stderr ao final da
+// execução e traceFile (se não nulo) recebe o trace em JSON
+void timingEnable(bool report, const char* traceFile);
+
+// Indica se a medição está habilitada
+bool timingEnabled();
+
+// Marca o início e o fim de uma fase; fases podem ser aninhadas e devem ser
+// encerradas na ordem inversa de abertura
+void timingBegin(const char* name);
+void timingEnd();
+
+// Mede a fase durante o escopo do objeto
+class PhaseTimer {
+public:
+    explicit PhaseTimer(const char* name) { timingBegin(name); }
+    ~PhaseTimer() { timingEnd(); }
+
+private:
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+};
+
+// Imprime o relatório das fases encerradas
+void timingPrintReport(FILE* output);
+
+// Escreve as fases encerradas no formato trace-event; retorna false se o
+// arquivo não pôde ser criado
+bool timingWriteTrace(const char* fileName);
+
+#endif // TIMING_HPP
@@ -0,0 +1,297 @@
+/*
+ * Compiladores - etapa7 - vm.cpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Implementação da máquina virtual. Com GCC/Clang o código é encadeado
+ * diretamente (direct threading): antes da execução cada instrução recebe
+ * o endereço do seu tratador, e cada tratador salta para o da seguinte sem
+ * passar por tabela; nos demais compiladores o despacho é um switch
+ */
+
+#include "vm.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#if defined(__GNUC__)
+#define VM_DIRECT_THREADED
+#endif
+
+// Limite de ativações simultâneas (recursão infinita vira erro de execução)
+#define VM_MAX_DEPTH (1 << 20)
+
+// Instrução encadeada: o código da instrução vira o endereço do tratador
+struct VmInstr {
+#ifdef VM_DIRECT_THREADED
+    const void* handler;
+#else
+    int32_t op;
+#endif
+    int32_t res;
+    int32_t op1;
+    int32_t op2;
+};
+
+// Ativação de função na pilha de chamadas
+struct VmCall {
+    const VmInstr* returnPc;    // Instrução seguinte à chamada
+    size_t frameBase;           // Frame do chamador
+    int function;               // Função do chamador
+    int result;                 // Operando do chamador que recebe o retorno
+};
+
+void vmPrintInt(int32_t value) {
+    char digits[16];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    *--p = '\n';
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    fwrite(p, 1, end - p, stdout);
+}
+
+// Operações em 32 bits com a aritmética modular das instruções de máquina
+static inline int32_t wrapAdd(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+static inline int32_t wrapSub(int32_t a, int32_t b) { return (int32_t)((uint32_t)a - (uint32_t)b); }
+static inline int32_t wrapMul(int32_t a, int32_t b) { return (int32_t)((uint32_t)a * (uint32_t)b); }
+
+bool vmRun(const BcProgram& program, int& result) {
+#ifdef VM_DIRECT_THREADED
+    // Tratadores na ordem dos códigos BC_*
+    static const void* handlers[BC_OPCODES] = {
+        &&op_move,   &&op_add,    &&op_sub,    &&op_mul,    &&op_div,          // 0-4
+        &&op_mod,    &&op_and,    &&op_or,     &&op_lt,     &&op_gt,           // 5-9
+        &&op_le,     &&op_ge,     &&op_eq,     &&op_dif,    &&op_not,          // 10-14
+        &&op_neg,    &&op_jump,   &&op_ifz,    &&op_ifnz,   &&op_jlt,          // 15-19
+        &&op_jgt,    &&op_jle,    &&op_jge,    &&op_jeq,    &&op_jne,          // 20-24
+        &&op_arg,    &&op_call,   &&op_ret,    &&op_print,  &&op_print_string, // 25-29
+        &&op_read,   &&op_vec_access, &&op_vec_write, &&op_vec_read            // 30-33
+    };
+#endif
+
+    // Código encadeado (a imagem já foi validada por bytecodeLoad)
+    const BcHeader* header = program.header;
+    std::vector<VmInstr> threaded(header->codeCount);
+    for (uint32_t i = 0; i < header->codeCount; i++) {
+        const BcInstr& instr = program.code[i];
+#ifdef VM_DIRECT_THREADED
+        threaded[i].handler = handlers[instr.op];
+#else
+        threaded[i].op = instr.op;
+#endif
+        threaded[i].res = instr.res;
+        threaded[i].op1 = instr.op1;
+        threaded[i].op2 = instr.op2;
+    }
+
+    // Área dos vetores: calloc deixa as páginas zeradas a cargo do sistema,
+    // que só as materializa quando usadas
+    int32_t* globals = program.globals;
+    std::unique_ptr<int32_t, void (*)(void*)> vectorArea(
+        static_cast<int32_t*>(calloc(header->vectorSlots + 1, sizeof(int32_t))), free);
+    int32_t* vectors = vectorArea.get();
+    if (!vectors) {
+        fprintf(stderr, "ERRO DE EXECUÇÃO: memória insuficiente para os vetores\n");
+        return false;
+    }
+    std::vector<int32_t> stack;         // Frames das ativações, contíguos
+    std::vector<int32_t> args;          // Argumentos avaliados (BC_ARG)
+    std::vector<VmCall> calls;
+
+    const VmInstr* code = threaded.data();
+    int function = header->mainIndex;
+    stack.resize(program.functions[function].frameSize, 0);
+    int32_t* frame = stack.data();
+    const VmInstr* pc = code + program.functions[function].entry;
+
+    const char* error = nullptr;
+    int32_t value;
+
+#define REF(x)  (*((x) >= 0 ? frame + (x) : globals + ~(x)))
+#define BINARY(expr) { int32_t a = REF(pc->op1), b = REF(pc->op2); REF(pc->res) = (expr); pc++; DISPATCH(); }
+#define BRANCH(cond) { int32_t a = REF(pc->op1), b = REF(pc->op2); \
+                       pc = (cond) ? code + pc->res : pc + 1; DISPATCH(); }
+#define TEST(cond)   { int32_t a = REF(pc->op1); pc = (cond) ? code + pc->res : pc + 1; DISPATCH(); }
+
+#ifdef VM_DIRECT_THREADED
+#define CASE(op, label) label
+#define DISPATCH()      goto *pc->handler
+    DISPATCH();
+#else
+#define CASE(op, label) case op
+#define DISPATCH()      continue
+    for (;;) {
+    switch (pc->op) {
+#endif
+
+    CASE(BC_MOVE, op_move):     REF(pc->res) = REF(pc->op1); pc++; DISPATCH();
+    CASE(BC_ADD, op_add):       BINARY(wrapAdd(a, b))
+    CASE(BC_SUB, op_sub):       BINARY(wrapSub(a, b))
+    CASE(BC_MUL, op_mul):       BINARY(wrapMul(a, b))
+    CASE(BC_AND, op_and):       BINARY(a & b)
+    CASE(BC_OR, op_or):         BINARY(a | b)
+    CASE(BC_LT, op_lt):         BINARY(a < b)
+    CASE(BC_GT, op_gt):         BINARY(a > b)
+    CASE(BC_LE, op_le):         BINARY(a <= b)
+    CASE(BC_GE, op_ge):         BINARY(a >= b)
+    CASE(BC_EQ, op_eq):         BINARY(a == b)
+    CASE(BC_DIF, op_dif):       BINARY(a != b)
+    CASE(BC_NOT, op_not):       REF(pc->res) = REF(pc->op1) == 0; pc++; DISPATCH();
+    CASE(BC_NEG, op_neg):       REF(pc->res) = wrapSub(0, REF(pc->op1)); pc++; DISPATCH();
+
+    CASE(BC_DIV, op_div): {
+        // idivl gera exceção nos dois casos
+        int32_t a = REF(pc->op1), b = REF(pc->op2);
+        if (b == 0 || (a == INT32_MIN && b == -1)) {
+            error = b == 0 ? "divisão por zero" : "estouro na divisão";
+            goto fail;
+        }
+        REF(pc->res) = a / b;
+        pc++;
+        DISPATCH();
+    }
+
+    CASE(BC_MOD, op_mod): {
+        int32_t a = REF(pc->op1), b = REF(pc->op2);
+        if (b == 0 || (a == INT32_MIN && b == -1)) {
+            error = b == 0 ? "divisão por zero" : "estouro na divisão";
+            goto fail;
+        }
+        REF(pc->res) = a % b;
+        pc++;
+        DISPATCH();
+    }
+
+    CASE(BC_JUMP, op_jump):     pc = code + pc->res; DISPATCH();
+    CASE(BC_IFZ, op_ifz):       TEST(a == 0)
+    CASE(BC_IFNZ, op_ifnz):     TEST(a != 0)
+    CASE(BC_JLT, op_jlt):       BRANCH(a < b)
+    CASE(BC_JGT, op_jgt):       BRANCH(a > b)
+    CASE(BC_JLE, op_jle):       BRANCH(a <= b)
+    CASE(BC_JGE, op_jge):       BRANCH(a >= b)
+    CASE(BC_JEQ, op_jeq):       BRANCH(a == b)
+    CASE(BC_JNE, op_jne):       BRANCH(a != b)
+
+    CASE(BC_ARG, op_arg):       args.push_back(REF(pc->op1)); pc++; DISPATCH();
+
+    CASE(BC_CALL, op_call): {
+        if (calls.size() >= VM_MAX_DEPTH) {
+            error = "recursão profunda demais";
+            goto fail;
+        }
+        const BcFunction& callee = program.functions[pc->op1];
+        VmCall call;
+        call.returnPc = pc + 1;
+        call.frameBase = frame - stack.data();
+        call.function = function;
+        call.result = pc->res;
+        calls.push_back(call);
+
+        // Novo frame (zerado) no topo da pilha; os argumentos pendentes
+        // mais recentes são os da chamada
+        size_t base = stack.size();
+        stack.resize(base + callee.frameSize, 0);
+        frame = stack.data() + base;
+        size_t count = callee.paramCount;
+        size_t first = args.size() >= count ? args.size() - count : 0;
+        const int32_t* params = program.params + callee.firstParam;
+        for (size_t i = 0; i < count && first + i < args.size(); i++) {
+            REF(params[i]) = args[first + i];
+        }
+        args.resize(first);
+
+        function = pc->op1;
+        pc = code + callee.entry;
+        DISPATCH();
+    }
+
+    CASE(BC_RET, op_ret): {
+        value = REF(pc->op1);
+        if (calls.empty()) {
+            result = value;
+            return true;
+        }
+        const VmCall& call = calls.back();
+        stack.resize(frame - stack.data());
+        frame = stack.data() + call.frameBase;
+        function = call.function;
+        pc = call.returnPc;
+        REF(call.result) = value;
+        calls.pop_back();
+        DISPATCH();
+    }
+
+    CASE(BC_PRINT, op_print):   vmPrintInt(REF(pc->op1)); pc++; DISPATCH();
+
+    CASE(BC_PRINT_STRING, op_print_string):
+        // puts: a string e uma quebra de linha
+        fwrite(program.text + pc->op1, 1, pc->op2, stdout);
+        fputc('\n', stdout);
+        pc++;
+        DISPATCH();
+
+    CASE(BC_READ, op_read): {
+        // Sem um inteiro na entrada a variável não muda (como no scanf)
+        int input;
+        if (scanf("%d", &input) == 1) REF(pc->res) = input;
+        pc++;
+        DISPATCH();
+    }
+
+    CASE(BC_VEC_ACCESS, op_vec_access): {
+        const BcVector& vector = program.vectors[pc->op1];
+        int32_t index = REF(pc->op2);
+        if (index < 0 || index >= vector.length) goto out_of_bounds;
+        REF(pc->res) = vectors[vector.base + index];
+        pc++;
+        DISPATCH();
+    }
+
+    CASE(BC_VEC_WRITE, op_vec_write): {
+        const BcVector& vector = program.vectors[pc->res];
+        int32_t index = REF(pc->op1);
+        if (index < 0 || index >= vector.length) goto out_of_bounds;
+        vectors[vector.base + index] = REF(pc->op2);
+        pc++;
+        DISPATCH();
+    }
+
+    CASE(BC_VEC_READ, op_vec_read): {
+        const BcVector& vector = program.vectors[pc->res];
+        int32_t index = REF(pc->op1);
+        if (index < 0 || index >= vector.length) goto out_of_bounds;
+        int input;
+        if (scanf("%d", &input) == 1) vectors[vector.base + index] = input;
+        pc++;
+        DISPATCH();
+    }
+
+#ifndef VM_DIRECT_THREADED
+    default:
+        error = "instrução inválida";
+        goto fail;
+    }
+    }
+#endif
+
+#undef REF
+#undef BINARY
+#undef BRANCH
+#undef TEST
+#undef CASE
+#undef DISPATCH
+
+out_of_bounds:
+    error = "índice fora dos limites do vetor";
+fail:
+    fflush(stdout);
+    fprintf(stderr, "ERRO DE EXECUÇÃO: %s (função %s)\n", error,
+            program.text + program.functions[function].name);
+    return false;
+}
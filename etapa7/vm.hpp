@@ -0,0 +1,26 @@
+/*
+ * Compiladores - etapa7 - vm.hpp - semestre 2025/2
+ * Autor: Santiago Gonzaga
+ *
+ * Definições da máquina virtual que executa o bytecode (bytecode.hpp):
+ * roda o programa sem passar pelo assembler, em qualquer plataforma
+ */
+
+#ifndef VM_HPP
+#define VM_HPP
+
+#include "bytecode.hpp"
+#include <cstdint>
+
+// Executa o programa a partir do main; a saída de print vai para stdout e
+// read lê de stdin. Retorna false em erro de execução (divisão por zero,
+// índice fora do vetor, recursão profunda demais), já reportado em stderr;
+// senão result recebe o valor devolvido por main. A memória global da
+// imagem é alterada pela execução
+bool vmRun(const BcProgram& program, int& result);
+
+// Imprime um inteiro em decimal seguido de '\n' (o "%d\n" do backend, sem
+// printf); também usada pelo código gerado pelo JIT
+void vmPrintInt(int32_t value);
+
+#endif // VM_HPP